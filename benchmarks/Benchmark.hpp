@@ -0,0 +1,80 @@
+#ifndef Benchmark_hpp
+#define Benchmark_hpp
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace Benchmark
+{
+    /**
+     * Run fn the given number of times after one warm-up run.
+     * \return Returns the median duration of a run in milliseconds
+     */
+    template<typename Function>
+    inline double measure(int repetitions, Function&& fn)
+    {
+        fn();
+
+        std::vector<double> durations;
+        durations.reserve(repetitions);
+
+        for (int i = 0; i < repetitions; ++i)
+        {
+            auto t_0 = std::chrono::steady_clock::now();
+            fn();
+            auto t_1 = std::chrono::steady_clock::now();
+
+            durations.push_back(std::chrono::duration<double, std::milli>(t_1 - t_0).count());
+        }
+
+        std::nth_element(durations.begin(), durations.begin() + durations.size() / 2, durations.end());
+
+        return durations[durations.size() / 2];
+    }
+
+    /**
+     * Like measure, but calls setup before every run without timing it, e.g. to start from a fresh state.
+     */
+    template<typename SetupFunction, typename Function>
+    inline double measure(int repetitions, SetupFunction&& setup, Function&& fn)
+    {
+        setup();
+        fn();
+
+        std::vector<double> durations;
+        durations.reserve(repetitions);
+
+        for (int i = 0; i < repetitions; ++i)
+        {
+            setup();
+
+            auto t_0 = std::chrono::steady_clock::now();
+            fn();
+            auto t_1 = std::chrono::steady_clock::now();
+
+            durations.push_back(std::chrono::duration<double, std::milli>(t_1 - t_0).count());
+        }
+
+        std::nth_element(durations.begin(), durations.begin() + durations.size() / 2, durations.end());
+
+        return durations[durations.size() / 2];
+    }
+
+    /**
+     * Print the duration of a run and the resulting time per item.
+     */
+    inline void report(std::string const& name, double duration_ms, size_t item_cnt)
+    {
+        std::cout << std::left << std::setw(48) << name
+            << std::right << std::fixed << std::setprecision(3)
+            << std::setw(10) << duration_ms << " ms"
+            << std::setw(10) << (duration_ms * 1.0e6 / static_cast<double>(item_cnt)) << " ns/item"
+            << std::endl;
+    }
+}
+
+#endif // !Benchmark_hpp
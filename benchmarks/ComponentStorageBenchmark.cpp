@@ -0,0 +1,106 @@
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Benchmark.hpp"
+#include "ComponentStorage.hpp"
+#include "TaskScheduler.hpp"
+
+using EngineCore::Utility::ComponentStorage;
+using EngineCore::Utility::TaskScheduler;
+
+namespace
+{
+    constexpr int repetitions = 10;
+    constexpr size_t page_size = 1024;
+    constexpr size_t component_cnt = 1 << 20;
+
+    /** Size of a typical small component, e.g. position and velocity */
+    struct Component
+    {
+        float position[3] = { 0.0f, 0.0f, 0.0f };
+        float velocity[3] = { 1.0f, 1.0f, 1.0f };
+    };
+
+    typedef ComponentStorage<Component, component_cnt / page_size, page_size> Storage;
+
+    void update(Component& component)
+    {
+        for (int i = 0; i < 3; ++i) {
+            component.position[i] += component.velocity[i] * 0.01f;
+        }
+    }
+
+    /**
+     * Fill the storage and delete components until only every stride-th one is left.
+     * \return Returns the number of live components
+     */
+    size_t fillStorage(Storage& storage, size_t stride)
+    {
+        for (size_t i = 0; i < component_cnt; ++i) {
+            storage.addComponent(Component());
+        }
+
+        for (size_t i = 0; i < component_cnt; ++i)
+        {
+            if (i % stride != 0) {
+                storage.deleteComponent(i);
+            }
+        }
+
+        return (component_cnt + stride - 1) / stride;
+    }
+
+    /** Check every slot, as systems had to without the live bitsets */
+    void scanAll(Storage& storage)
+    {
+        for (size_t page_index = 0; page_index < storage.getUsedPageCount(); ++page_index)
+        {
+            for (size_t index_in_page = 0; index_in_page < page_size; ++index_in_page)
+            {
+                if (storage.checkComponent(page_index, index_in_page)) {
+                    update(storage(page_index, index_in_page));
+                }
+            }
+        }
+    }
+
+    void benchmarkDensity(TaskScheduler& task_scheduler, size_t stride)
+    {
+        auto storage = std::make_unique<Storage>();
+        size_t live_cnt = fillStorage(*storage, stride);
+
+        std::string const density = std::to_string(100 / stride) + "% live";
+
+        double duration_ms = Benchmark::measure(repetitions, [&storage]() { scanAll(*storage); });
+        Benchmark::report(density + ": scan all slots", duration_ms, live_cnt);
+
+        duration_ms = Benchmark::measure(repetitions, [&storage]() {
+            storage->forEach([](size_t, Component& component) { update(component); });
+        });
+        Benchmark::report(density + ": forEach", duration_ms, live_cnt);
+
+        duration_ms = Benchmark::measure(repetitions, [&task_scheduler, &storage]() {
+            task_scheduler.parallelFor(0, storage->getUsedPageCount(), [&storage](size_t page_begin, size_t page_end) {
+                storage->forEachPage(page_begin, page_end, [](size_t, Component& component) { update(component); });
+            }, 16);
+        });
+        Benchmark::report(density + ": parallelFor over forEachPage", duration_ms, live_cnt);
+    }
+}
+
+int main()
+{
+    TaskScheduler task_scheduler;
+    task_scheduler.run(std::max(1, static_cast<int>(std::thread::hardware_concurrency())), TaskScheduler::Mode::WORK_STEALING);
+
+    // dense, sparse, and very sparse storages
+    for (size_t stride : { 1, 10, 100 }) {
+        benchmarkDensity(task_scheduler, stride);
+    }
+
+    task_scheduler.stop();
+
+    return 0;
+}
@@ -0,0 +1,197 @@
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cstdlib>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "Benchmark.hpp"
+#include "SingleInstanceIndexMap.hpp"
+
+using EngineCore::Utility::SingleInstanceIndexMap;
+
+namespace
+{
+    /** Heap memory currently allocated by the process */
+    std::atomic_size_t allocated_bytes = 0;
+
+    /** Allocations are prefixed with their size, so that the unsized delete can account for them */
+    constexpr size_t size_header = alignof(std::max_align_t);
+}
+
+void* operator new(size_t size)
+{
+    if (void* ptr = std::malloc(size + size_header))
+    {
+        *static_cast<size_t*>(ptr) = size;
+        allocated_bytes.fetch_add(size, std::memory_order_relaxed);
+        return static_cast<char*>(ptr) + size_header;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept
+{
+    if (ptr == nullptr) {
+        return;
+    }
+
+    void* base = static_cast<char*>(ptr) - size_header;
+    allocated_bytes.fetch_sub(*static_cast<size_t*>(base), std::memory_order_relaxed);
+    std::free(base);
+}
+
+void operator delete(void* ptr, size_t) noexcept
+{
+    operator delete(ptr);
+}
+
+namespace
+{
+    /**
+     * Layout of SingleInstanceIndexMap before the paged sparse rework, kept for comparison:
+     * all page slots up front, 16000 atomic indices per touched page, std::div and bounds checked lookups.
+     */
+    class BaselineIndexMap
+    {
+    public:
+        BaselineIndexMap() : index_map_(page_cnt_) {}
+
+        void addIndex(unsigned int entity_id, size_t component_index)
+        {
+            std::unique_lock<std::mutex> lock(add_index_mutex_);
+
+            auto div = std::div(static_cast<long>(entity_id), static_cast<long>(page_size_));
+
+            if (!index_map_[div.quot].loaded.test())
+            {
+                index_map_[div.quot].storage = std::make_unique<std::vector<std::atomic_size_t>>(page_size_);
+                for (size_t j = 0; j < page_size_; ++j) {
+                    index_map_[div.quot].storage->at(j).store((std::numeric_limits<size_t>::max)());
+                }
+                index_map_[div.quot].loaded.test_and_set();
+            }
+
+            index_map_[div.quot].storage->at(div.rem).store(component_index);
+        }
+
+        size_t getIndex(unsigned int entity_id) const
+        {
+            auto div = std::div(static_cast<long>(entity_id), static_cast<long>(page_size_));
+
+            if (index_map_[div.quot].loaded.test()) {
+                return index_map_[div.quot].storage->at(div.rem).load();
+            }
+
+            return (std::numeric_limits<size_t>::max)();
+        }
+
+    private:
+        struct Page
+        {
+            std::unique_ptr<std::vector<std::atomic_size_t>> storage;
+            std::atomic_flag loaded = ATOMIC_FLAG_INIT;
+        };
+
+        std::vector<Page> index_map_;
+
+        static constexpr size_t page_cnt_ = 10000;
+        static constexpr size_t page_size_ = 16000;
+
+        std::mutex add_index_mutex_;
+    };
+
+    constexpr int repetitions = 10;
+
+    template<typename IndexMap>
+    std::unique_ptr<IndexMap> fillMap(std::vector<unsigned int> const& entity_ids, size_t& bytes)
+    {
+        size_t bytes_before = allocated_bytes.load();
+
+        auto index_map = std::make_unique<IndexMap>();
+        for (size_t i = 0; i < entity_ids.size(); ++i) {
+            index_map->addIndex(entity_ids[i], i);
+        }
+
+        bytes = allocated_bytes.load() - bytes_before;
+
+        return index_map;
+    }
+
+    void reportMemory(std::string const& name, size_t bytes, size_t entity_cnt)
+    {
+        std::cout << std::left << std::setw(48) << name
+            << std::right << std::fixed << std::setprecision(3)
+            << std::setw(10) << static_cast<double>(bytes) / (1024.0 * 1024.0) << " MB"
+            << std::setw(12) << static_cast<double>(bytes) / static_cast<double>(entity_cnt) << " bytes/entity"
+            << std::endl;
+    }
+
+    /**
+     * \param entity_cnt Number of entities with the component
+     * \param id_stride Distance between their entity ids, i.e. 1 if all entities have the component
+     */
+    void benchmarkIds(std::string const& name, size_t entity_cnt, size_t id_stride)
+    {
+        std::vector<unsigned int> entity_ids(entity_cnt);
+        for (size_t i = 0; i < entity_cnt; ++i) {
+            entity_ids[i] = static_cast<unsigned int>(i * id_stride);
+        }
+
+        // systems look up entities in no particular order
+        std::vector<unsigned int> lookup_ids = entity_ids;
+        std::shuffle(lookup_ids.begin(), lookup_ids.end(), std::mt19937(42));
+
+        size_t baseline_bytes = 0;
+        auto baseline_map = fillMap<BaselineIndexMap>(entity_ids, baseline_bytes);
+
+        size_t bytes = 0;
+        auto index_map = fillMap<SingleInstanceIndexMap>(entity_ids, bytes);
+
+        reportMemory(name + ": baseline, memory", baseline_bytes, entity_cnt);
+        reportMemory(name + ": memory", bytes, entity_cnt);
+
+        size_t checksum = 0;
+
+        double duration_ms = Benchmark::measure(repetitions, [&baseline_map, &lookup_ids, &checksum]() {
+            for (auto entity_id : lookup_ids) {
+                checksum += baseline_map->getIndex(entity_id);
+            }
+        });
+        Benchmark::report(name + ": baseline, getIndex", duration_ms, entity_cnt);
+
+        duration_ms = Benchmark::measure(repetitions, [&index_map, &lookup_ids, &checksum]() {
+            for (auto entity_id : lookup_ids) {
+                checksum += index_map->getIndex(entity_id);
+            }
+        });
+        Benchmark::report(name + ": getIndex", duration_ms, entity_cnt);
+
+        std::vector<size_t> indices(entity_cnt);
+        duration_ms = Benchmark::measure(repetitions, [&index_map, &lookup_ids, &indices, &checksum]() {
+            index_map->getIndices(lookup_ids, indices);
+            checksum += indices.back();
+        });
+        Benchmark::report(name + ": getIndices", duration_ms, entity_cnt);
+
+        // keep the lookups from being optimized away
+        if (checksum == 0) {
+            std::cout << "checksum " << checksum << std::endl;
+        }
+    }
+}
+
+int main()
+{
+    // every entity has the component, every 160th has it, and a few entities spread over the whole id range
+    benchmarkIds("100k dense ids", 100000, 1);
+    benchmarkIds("100k ids, stride 160", 100000, 160);
+    benchmarkIds("1k ids, stride 16000", 1000, 16000);
+
+    return 0;
+}
@@ -0,0 +1,100 @@
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Benchmark.hpp"
+#include "MPMCQueue.hpp"
+#include "MTQueue.hpp"
+
+using EngineCore::Utility::MPMCQueue;
+using EngineCore::Utility::MTQueue;
+
+namespace
+{
+    constexpr int repetitions = 5;
+    constexpr size_t item_cnt = 1 << 20;
+
+    /**
+     * Push item_cnt elements from producer_cnt threads and pop them from consumer_cnt threads concurrently.
+     */
+    template<typename Queue>
+    void pushPop(Queue& queue, int producer_cnt, int consumer_cnt)
+    {
+        std::vector<std::thread> threads;
+
+        for (int producer_idx = 0; producer_idx < producer_cnt; ++producer_idx)
+        {
+            threads.emplace_back([&queue, producer_cnt]() {
+                for (size_t i = 0; i < item_cnt / producer_cnt; ++i) {
+                    queue.push(i);
+                }
+            });
+        }
+
+        for (int consumer_idx = 0; consumer_idx < consumer_cnt; ++consumer_idx)
+        {
+            threads.emplace_back([&queue, consumer_cnt]() {
+                size_t val = 0;
+                for (size_t i = 0; i < item_cnt / consumer_cnt; ++i) {
+                    queue.pop(val);
+                }
+            });
+        }
+
+        for (auto& thread : threads) {
+            thread.join();
+        }
+    }
+
+    /** Uncontended cost of a push/pop pair, i.e. the locking overhead alone */
+    template<typename Queue>
+    void benchmarkUncontended(std::string const& name, Queue& queue)
+    {
+        double duration_ms = Benchmark::measure(repetitions, [&queue]() {
+            size_t val = 0;
+            for (size_t i = 0; i < item_cnt; ++i)
+            {
+                queue.push(i);
+                queue.pop(val);
+            }
+        });
+
+        Benchmark::report(name + ", uncontended push/pop", duration_ms, item_cnt);
+    }
+
+    template<typename Queue>
+    void benchmarkQueue(std::string const& name, Queue& queue, int producer_cnt, int consumer_cnt)
+    {
+        double duration_ms = Benchmark::measure(repetitions, [&queue, producer_cnt, consumer_cnt]() { pushPop(queue, producer_cnt, consumer_cnt); });
+
+        Benchmark::report(name + ", " + std::to_string(producer_cnt) + " producers, " + std::to_string(consumer_cnt) + " consumers", duration_ms, item_cnt);
+    }
+}
+
+int main()
+{
+    {
+        MTQueue<size_t> mt_queue;
+        benchmarkUncontended("MTQueue", mt_queue);
+
+        MPMCQueue<size_t> mpmc_queue;
+        benchmarkUncontended("MPMCQueue", mpmc_queue);
+    }
+
+    // single render thread consuming from one or many loaders, and fully contended
+    std::vector<std::pair<int, int>> const thread_cnts = { { 1, 1 }, { 4, 1 }, { 4, 4 } };
+
+    for (auto [producer_cnt, consumer_cnt] : thread_cnts)
+    {
+        MTQueue<size_t> mt_queue;
+        benchmarkQueue("MTQueue", mt_queue, producer_cnt, consumer_cnt);
+
+        MPMCQueue<size_t> bounded_queue(4096, MPMCQueue<size_t>::Capacity::BOUNDED);
+        benchmarkQueue("MPMCQueue bounded", bounded_queue, producer_cnt, consumer_cnt);
+
+        MPMCQueue<size_t> unbounded_queue(4096, MPMCQueue<size_t>::Capacity::UNBOUNDED);
+        benchmarkQueue("MPMCQueue unbounded", unbounded_queue, producer_cnt, consumer_cnt);
+    }
+
+    return 0;
+}
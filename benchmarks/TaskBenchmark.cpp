@@ -0,0 +1,141 @@
+#include <atomic>
+#include <cstdlib>
+#include <functional>
+#include <new>
+#include <string>
+#include <vector>
+
+#include "Benchmark.hpp"
+#include "Task.hpp"
+#include "TaskScheduler.hpp"
+
+using EngineCore::Utility::Task;
+using EngineCore::Utility::TaskGroup;
+using EngineCore::Utility::TaskScheduler;
+
+namespace
+{
+    std::atomic_size_t allocation_cnt = 0;
+}
+
+// count all heap allocations of the process
+void* operator new(size_t size)
+{
+    allocation_cnt.fetch_add(1, std::memory_order_relaxed);
+    if (void* ptr = std::malloc(size == 0 ? 1 : size)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept
+{
+    std::free(ptr);
+}
+
+namespace
+{
+    constexpr int repetitions = 10;
+    constexpr size_t task_cnt = 100000;
+
+    /** Typical capture of a system task: a few pointers and a pair of indices */
+    struct Capture
+    {
+        std::atomic_size_t* counter;
+        void const* manager_a;
+        void const* manager_b;
+        void const* scheduler;
+        size_t from;
+        size_t to;
+    };
+
+    template<typename Function>
+    void reportAllocations(std::string const& name, size_t item_cnt, Function&& fn)
+    {
+        size_t allocation_cnt_before = allocation_cnt.load();
+        fn();
+        size_t allocation_cnt_after = allocation_cnt.load();
+
+        std::cout << std::left << std::setw(48) << name
+            << std::right << std::fixed << std::setprecision(3)
+            << std::setw(10) << static_cast<double>(allocation_cnt_after - allocation_cnt_before) / static_cast<double>(item_cnt)
+            << " allocations/item" << std::endl;
+    }
+
+    /** Construct, hand over twice (as on the way into a queue) and invoke a callable wrapper */
+    template<typename Callable>
+    void createMoveInvoke(std::atomic_size_t& counter, std::vector<Callable>& queue)
+    {
+        queue.clear();
+        for (size_t i = 0; i < task_cnt; ++i)
+        {
+            Capture capture = { &counter, &counter, &queue, nullptr, i, i + 1 };
+            Callable callable([capture]() { capture.counter->fetch_add(capture.to - capture.from, std::memory_order_relaxed); });
+            Callable moved(std::move(callable));
+            queue.push_back(std::move(moved));
+        }
+        for (auto& callable : queue) {
+            callable();
+        }
+    }
+
+    template<typename Callable>
+    void benchmarkCallable(std::string const& name)
+    {
+        std::atomic_size_t counter = 0;
+        std::vector<Callable> queue;
+        queue.reserve(task_cnt);
+
+        double duration_ms = Benchmark::measure(repetitions, [&counter, &queue]() { createMoveInvoke(counter, queue); });
+
+        Benchmark::report(name, duration_ms, task_cnt);
+        reportAllocations(name, task_cnt, [&counter, &queue]() { createMoveInvoke(counter, queue); });
+    }
+
+    void submitTasks(TaskScheduler& task_scheduler, std::atomic_size_t& counter)
+    {
+        TaskGroup task_group;
+        for (size_t i = 0; i < task_cnt; ++i)
+        {
+            Capture capture = { &counter, &counter, &task_scheduler, nullptr, i, i + 1 };
+            task_scheduler.submitTask([capture]() { capture.counter->fetch_add(capture.to - capture.from, std::memory_order_relaxed); }, task_group);
+        }
+        task_scheduler.wait(task_group);
+    }
+
+    void benchmarkSubmission(TaskScheduler::Mode mode)
+    {
+        std::string const name = mode == TaskScheduler::Mode::SHARED_QUEUE ? "submitTask, shared queue" : "submitTask, work stealing";
+
+        TaskScheduler task_scheduler;
+        task_scheduler.run(1, mode);
+
+        std::atomic_size_t counter = 0;
+
+        double duration_ms = Benchmark::measure(repetitions, [&task_scheduler, &counter]() { submitTasks(task_scheduler, counter); });
+
+        // measure() warmed up queues and task pools, i.e. this is the steady state
+        Benchmark::report(name, duration_ms, task_cnt);
+        reportAllocations(name, task_cnt, [&task_scheduler, &counter]() { submitTasks(task_scheduler, counter); });
+
+        task_scheduler.stop();
+    }
+}
+
+int main()
+{
+    std::cout << "Capture size: " << sizeof(Capture) << " bytes, Task inline capacity: " << Task::inline_capacity << " bytes" << std::endl;
+
+    benchmarkCallable<std::function<void()>>("std::function");
+    benchmarkCallable<Task>("Task");
+
+    benchmarkSubmission(TaskScheduler::Mode::SHARED_QUEUE);
+    benchmarkSubmission(TaskScheduler::Mode::WORK_STEALING);
+
+    return 0;
+}
@@ -0,0 +1,101 @@
+#include <atomic>
+#include <string>
+#include <thread>
+
+#include "Benchmark.hpp"
+#include "TaskScheduler.hpp"
+
+using EngineCore::Utility::TaskGroup;
+using EngineCore::Utility::TaskScheduler;
+
+namespace
+{
+    constexpr int repetitions = 10;
+    constexpr size_t task_cnt = 100000;
+    constexpr size_t item_cnt = 1 << 20;
+
+    std::string modeName(TaskScheduler::Mode mode)
+    {
+        return mode == TaskScheduler::Mode::SHARED_QUEUE ? "shared queue" : "work stealing";
+    }
+
+    /** Fine-grained tasks submitted from the main thread */
+    void benchmarkExternalSubmission(TaskScheduler& task_scheduler)
+    {
+        std::atomic_size_t executed_cnt = 0;
+
+        double duration_ms = Benchmark::measure(repetitions, [&task_scheduler, &executed_cnt]() {
+            TaskGroup task_group;
+            for (size_t i = 0; i < task_cnt; ++i) {
+                task_scheduler.submitTask([&executed_cnt]() { executed_cnt.fetch_add(1, std::memory_order_relaxed); }, task_group);
+            }
+            task_scheduler.wait(task_group);
+        });
+
+        Benchmark::report(modeName(task_scheduler.getMode()) + ": external submission", duration_ms, task_cnt);
+    }
+
+    /** Fine-grained tasks submitted from within tasks, as done by systems splitting up their work */
+    void benchmarkNestedSubmission(TaskScheduler& task_scheduler)
+    {
+        std::atomic_size_t executed_cnt = 0;
+
+        size_t const root_task_cnt = static_cast<size_t>(std::max(1, task_scheduler.getWorkerThreadCount()));
+        size_t const child_task_cnt = task_cnt / root_task_cnt;
+
+        double duration_ms = Benchmark::measure(repetitions, [&task_scheduler, &executed_cnt, root_task_cnt, child_task_cnt]() {
+            TaskGroup task_group;
+            for (size_t i = 0; i < root_task_cnt; ++i)
+            {
+                task_scheduler.submitTask([&task_scheduler, &executed_cnt, task_group, child_task_cnt]() mutable {
+                    for (size_t j = 0; j < child_task_cnt; ++j) {
+                        task_scheduler.submitTask([&executed_cnt]() { executed_cnt.fetch_add(1, std::memory_order_relaxed); }, task_group);
+                    }
+                }, task_group);
+            }
+            task_scheduler.wait(task_group);
+        });
+
+        Benchmark::report(modeName(task_scheduler.getMode()) + ": nested submission", duration_ms, root_task_cnt * child_task_cnt);
+    }
+
+    /** Small per-item work split into many chunks */
+    void benchmarkParallelFor(TaskScheduler& task_scheduler)
+    {
+        std::vector<float> values(item_cnt, 1.0f);
+
+        double duration_ms = Benchmark::measure(repetitions, [&task_scheduler, &values]() {
+            task_scheduler.parallelFor(0, values.size(), [&values](size_t from, size_t to) {
+                for (size_t i = from; i < to; ++i) {
+                    values[i] = values[i] * 0.5f + 1.0f;
+                }
+            }, 256);
+        });
+
+        Benchmark::report(modeName(task_scheduler.getMode()) + ": parallelFor, grain size 256", duration_ms, item_cnt);
+    }
+}
+
+/**
+ * Usage: TaskSchedulerBenchmark [worker_thread_cnt], defaults to one worker per hardware thread.
+ */
+int main(int argc, char** argv)
+{
+    int const worker_thread_cnt = argc > 1 ? std::max(1, std::stoi(argv[1])) : std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+
+    std::cout << "Worker threads: " << worker_thread_cnt << std::endl;
+
+    for (auto mode : { TaskScheduler::Mode::SHARED_QUEUE, TaskScheduler::Mode::WORK_STEALING })
+    {
+        TaskScheduler task_scheduler;
+        task_scheduler.run(worker_thread_cnt, mode);
+
+        benchmarkExternalSubmission(task_scheduler);
+        benchmarkNestedSubmission(task_scheduler);
+        benchmarkParallelFor(task_scheduler);
+
+        task_scheduler.stop();
+    }
+
+    return 0;
+}
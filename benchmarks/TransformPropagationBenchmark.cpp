@@ -0,0 +1,135 @@
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Benchmark.hpp"
+#include "CpuTopology.hpp"
+#include "EntityManager.hpp"
+#include "TaskScheduler.hpp"
+#include "TransformComponentManager.hpp"
+
+using EngineCore::Common::TransformComponentManager;
+using EngineCore::Utility::CpuTopology;
+using EngineCore::Utility::TaskScheduler;
+
+namespace
+{
+    constexpr int repetitions = 20;
+    constexpr size_t root_cnt = 1024;
+    /** Every root has child_cnt children with child_cnt grandchildren each */
+    constexpr size_t child_cnt = 7;
+    constexpr size_t transforms_per_root = 1 + child_cnt + child_cnt * child_cnt;
+
+    /**
+     * Scene of root_cnt independent hierarchies, e.g. vehicles with attached parts.
+     * \return Returns the component indices of the roots
+     */
+    std::vector<size_t> createScene(EntityManager& entity_mngr, TransformComponentManager& transform_mngr)
+    {
+        std::vector<size_t> root_indices;
+        root_indices.reserve(root_cnt);
+
+        for (size_t i = 0; i < root_cnt; ++i)
+        {
+            Entity root = entity_mngr.create();
+            root_indices.push_back(transform_mngr.addComponent(root, Vec3(static_cast<float>(i), 0.0f, 0.0f)));
+
+            for (size_t j = 0; j < child_cnt; ++j)
+            {
+                Entity child = entity_mngr.create();
+                transform_mngr.setParent(transform_mngr.addComponent(child, Vec3(1.0f, 0.0f, 0.0f)), root);
+
+                for (size_t k = 0; k < child_cnt; ++k)
+                {
+                    Entity grandchild = entity_mngr.create();
+                    transform_mngr.setParent(transform_mngr.addComponent(grandchild, Vec3(0.0f, 1.0f, 0.0f)), child);
+                }
+            }
+        }
+
+        transform_mngr.propagateChanges();
+
+        return root_indices;
+    }
+
+    /** Move all roots from the worker threads, as animation systems do */
+    void translateRoots(TaskScheduler& task_scheduler, TransformComponentManager& transform_mngr, std::vector<size_t> const& root_indices)
+    {
+        task_scheduler.parallelFor(0, root_indices.size(), [&transform_mngr, &root_indices](size_t from, size_t to) {
+            for (size_t i = from; i < to; ++i) {
+                transform_mngr.translate(root_indices[i], Vec3(0.0f, 0.0f, 0.01f));
+            }
+        }, 16);
+    }
+
+    void benchmarkConfig(std::string const& name, TaskScheduler& task_scheduler)
+    {
+        std::cout << name << ", " << task_scheduler.getWorkerThreadCount() << " worker threads" << std::endl;
+
+        {
+            EntityManager entity_mngr;
+            auto transform_mngr = std::make_unique<TransformComponentManager>(TransformComponentManager::Propagation::IMMEDIATE);
+            auto root_indices = createScene(entity_mngr, *transform_mngr);
+
+            // every translate recomputes the root's subtree on the calling worker
+            double duration_ms = Benchmark::measure(repetitions, [&task_scheduler, &transform_mngr, &root_indices]() {
+                translateRoots(task_scheduler, *transform_mngr, root_indices);
+            });
+
+            Benchmark::report("  immediate propagation", duration_ms, root_cnt * transforms_per_root);
+        }
+
+        {
+            EntityManager entity_mngr;
+            auto transform_mngr = std::make_unique<TransformComponentManager>(TransformComponentManager::Propagation::DEFERRED);
+            auto root_indices = createScene(entity_mngr, *transform_mngr);
+
+            // translates only record the roots, all subtrees are recomputed once at the sync point
+            double duration_ms = Benchmark::measure(repetitions, [&task_scheduler, &transform_mngr, &root_indices]() {
+                translateRoots(task_scheduler, *transform_mngr, root_indices);
+                transform_mngr->propagateChanges();
+            });
+
+            Benchmark::report("  deferred propagation", duration_ms, root_cnt * transforms_per_root);
+        }
+    }
+}
+
+int main()
+{
+    CpuTopology topology = CpuTopology::detect();
+
+    std::cout << "Logical cores: " << topology.logical_cores.size()
+        << ", physical cores: " << topology.getPhysicalCoreCount()
+        << ", NUMA nodes: " << topology.numa_node_cnt << std::endl;
+
+    {
+        TaskScheduler task_scheduler;
+        task_scheduler.run(topology.getPhysicalCoreCount(), TaskScheduler::Mode::WORK_STEALING);
+        benchmarkConfig("Fixed worker count, no pinning", task_scheduler);
+        task_scheduler.stop();
+    }
+
+    {
+        TaskScheduler task_scheduler;
+        task_scheduler.run(TaskScheduler::Config{});
+        benchmarkConfig("Topology config, no pinning", task_scheduler);
+        task_scheduler.stop();
+    }
+
+    {
+        TaskScheduler task_scheduler;
+        task_scheduler.run(TaskScheduler::Config{ 0, TaskScheduler::Mode::WORK_STEALING, true, false });
+        benchmarkConfig("Topology config, pinned", task_scheduler);
+        task_scheduler.stop();
+    }
+
+    {
+        TaskScheduler task_scheduler;
+        task_scheduler.run(TaskScheduler::Config{ 0, TaskScheduler::Mode::WORK_STEALING, true, true });
+        benchmarkConfig("Topology config, pinned, render thread core reserved", task_scheduler);
+        task_scheduler.stop();
+    }
+
+    return 0;
+}
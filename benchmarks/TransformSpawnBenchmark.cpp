@@ -0,0 +1,117 @@
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "Benchmark.hpp"
+#include "CommandBuffer.hpp"
+#include "EntityManager.hpp"
+#include "TaskScheduler.hpp"
+#include "TransformComponentManager.hpp"
+
+using EngineCore::Common::TransformComponentManager;
+using EngineCore::Utility::CommandBuffer;
+using EngineCore::Utility::TaskScheduler;
+
+namespace
+{
+    constexpr int repetitions = 5;
+    constexpr size_t spawn_cnt = 1000000;
+    constexpr size_t grain_size = 4096;
+
+    /** Recording alone: per-thread command buffers against a single mutex protected vector */
+    void benchmarkRecording(TaskScheduler& task_scheduler)
+    {
+        CommandBuffer<size_t> command_buffer;
+        std::vector<size_t> commands;
+
+        double duration_ms = Benchmark::measure(repetitions, [&task_scheduler, &command_buffer, &commands]() {
+            task_scheduler.parallelFor(0, spawn_cnt, [&command_buffer](size_t from, size_t to) {
+                for (size_t i = from; i < to; ++i) {
+                    command_buffer.record(i);
+                }
+            }, grain_size);
+
+            commands.clear();
+            command_buffer.take(commands);
+        });
+        Benchmark::report("CommandBuffer record + take", duration_ms, spawn_cnt);
+
+        std::mutex mutex;
+
+        duration_ms = Benchmark::measure(repetitions, [&task_scheduler, &mutex, &commands]() {
+            commands.clear();
+            task_scheduler.parallelFor(0, spawn_cnt, [&mutex, &commands](size_t from, size_t to) {
+                for (size_t i = from; i < to; ++i)
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    commands.push_back(i);
+                }
+            }, grain_size);
+        });
+        Benchmark::report("mutex protected vector push_back", duration_ms, spawn_cnt);
+    }
+
+    /** Spawn of spawn_cnt transforms from the worker threads, e.g. a parallel scene import */
+    void benchmarkSpawn(TaskScheduler& task_scheduler)
+    {
+        EntityManager entity_mngr;
+        std::vector<Entity> entities = entity_mngr.create(spawn_cnt);
+
+        std::unique_ptr<TransformComponentManager> transform_mngr;
+        auto resetManager = [&transform_mngr]() {
+            transform_mngr.reset();
+            transform_mngr = std::make_unique<TransformComponentManager>();
+        };
+
+        double duration_ms = Benchmark::measure(repetitions, resetManager, [&task_scheduler, &transform_mngr, &entities]() {
+            task_scheduler.parallelFor(0, entities.size(), [&transform_mngr, &entities](size_t from, size_t to) {
+                for (size_t i = from; i < to; ++i) {
+                    transform_mngr->addComponent(entities[i], Vec3(static_cast<float>(i), 0.0f, 0.0f));
+                }
+            }, grain_size);
+        });
+        Benchmark::report("parallel addComponent", duration_ms, spawn_cnt);
+
+        duration_ms = Benchmark::measure(repetitions, resetManager, [&task_scheduler, &transform_mngr, &entities]() {
+            task_scheduler.parallelFor(0, entities.size(), [&transform_mngr, &entities](size_t from, size_t to) {
+                for (size_t i = from; i < to; ++i) {
+                    transform_mngr->recordAddComponent(entities[i], Vec3(static_cast<float>(i), 0.0f, 0.0f));
+                }
+            }, grain_size);
+
+            transform_mngr->applyCommandBuffers();
+        });
+        Benchmark::report("parallel recordAddComponent + applyCommandBuffers", duration_ms, spawn_cnt);
+
+        std::vector<TransformComponentManager::ComponentParameters> components(entities.size());
+        for (size_t i = 0; i < entities.size(); ++i) {
+            components[i] = { entities[i], Vec3(static_cast<float>(i), 0.0f, 0.0f) };
+        }
+
+        duration_ms = Benchmark::measure(repetitions, resetManager, [&transform_mngr, &components]() {
+            transform_mngr->addComponents(components);
+        });
+        Benchmark::report("single thread addComponents", duration_ms, spawn_cnt);
+    }
+}
+
+/**
+ * Usage: TransformSpawnBenchmark [worker_thread_cnt], defaults to one worker per hardware thread.
+ */
+int main(int argc, char** argv)
+{
+    int const worker_thread_cnt = argc > 1 ? std::max(1, std::stoi(argv[1])) : std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+
+    std::cout << "Worker threads: " << worker_thread_cnt << std::endl;
+
+    TaskScheduler task_scheduler;
+    task_scheduler.run(worker_thread_cnt, TaskScheduler::Mode::WORK_STEALING);
+
+    benchmarkRecording(task_scheduler);
+    benchmarkSpawn(task_scheduler);
+
+    task_scheduler.stop();
+
+    return 0;
+}
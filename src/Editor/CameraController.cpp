@@ -132,6 +132,9 @@ void Editor::Controls::CameraController::controlCameraKeyboardAction(
         m_mouse_right_pressed = false;
     }
 
+    // the view matrix and the next control action read the camera's world transform before changes are propagated
+    transform_mngr.updateWorldTransforms(camera_transform_idx);
+
     // TODO reduce camera latency by updating current render frame, camera view matrix is no longer accessible in frame (or used from frame anyway)
 
     //m_frame_manager.getRenderFrame().m_view_matrix = glm::inverse(transform_mngr.getWorldTransformation(camera_transform_idx));
@@ -198,4 +201,7 @@ void Editor::Controls::CameraController::controlCameraGamepadAction(
 
         transform_mngr.rotateLocal(camera_transform_idx, rotation);
     }
+
+    // the view matrix and the next control action read the camera's world transform before changes are propagated
+    transform_mngr.updateWorldTransforms(camera_transform_idx);
 }
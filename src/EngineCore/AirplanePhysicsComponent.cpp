@@ -142,6 +142,38 @@ namespace EngineCore
             // TODO update stuff
         }
 
+        void AirplanePhysicsComponentManager::deleteComponent(Entity entity)
+        {
+            deleteComponents(std::span<Entity const>(&entity, 1));
+        }
+
+        void AirplanePhysicsComponentManager::deleteComponents(std::span<Entity const> entities)
+        {
+            std::unique_lock<std::mutex> lock(m_data_mutex);
+
+            m_data.used = static_cast<uint>(compactComponents(entities, m_data.used,
+                [this](size_t src_index, size_t dst_index) {
+                    m_data.entity[dst_index] = m_data.entity[src_index];
+                    m_data.velocity[dst_index] = m_data.velocity[src_index];
+                    m_data.acceleration[dst_index] = m_data.acceleration[src_index];
+                    m_data.engine_thrust[dst_index] = m_data.engine_thrust[src_index];
+                    m_data.elevator_angle[dst_index] = m_data.elevator_angle[src_index];
+                    m_data.rudder_angle[dst_index] = m_data.rudder_angle[src_index];
+                    m_data.aileron_angle[dst_index] = m_data.aileron_angle[src_index];
+                    m_data.pitch_torque[dst_index] = m_data.pitch_torque[src_index];
+                    m_data.roll_torque[dst_index] = m_data.roll_torque[src_index];
+                    m_data.yaw_torque[dst_index] = m_data.yaw_torque[src_index];
+                    m_data.angle_of_attack[dst_index] = m_data.angle_of_attack[src_index];
+                    m_data.angle_of_sideslip[dst_index] = m_data.angle_of_sideslip[src_index];
+                    m_data.lift_coefficient[dst_index] = m_data.lift_coefficient[src_index];
+                    m_data.drag_coefficient[dst_index] = m_data.drag_coefficient[src_index];
+                    m_data.aerodynamic_drag[dst_index] = m_data.aerodynamic_drag[src_index];
+                    m_data.aerodynamic_lift[dst_index] = m_data.aerodynamic_lift[src_index];
+                    m_data.wing_surface[dst_index] = m_data.wing_surface[src_index];
+                    m_data.mass[dst_index] = m_data.mass[src_index];
+                }));
+        }
+
         void AirplanePhysicsComponentManager::update(float timestep)
         {
             std::unique_lock<std::mutex> lock(m_data_mutex);
@@ -77,6 +77,8 @@ namespace EngineCore
 
             void deleteComponent(Entity entity);
 
+            void deleteComponents(std::span<Entity const> entities) override;
+
             void update(float timestep);
 
             std::pair<bool, uint> getIndex(uint entity_id) const;
@@ -1,5 +1,7 @@
 #include "AnimationSystems.hpp"
 
+#include "WorldState.hpp"
+
 void EngineCore::Animation::animateTurntables(
     EngineCore::Common::TransformComponentManager & transform_mngr,
     EngineCore::Animation::TurntableComponentManager & turntable_mngr,
@@ -8,27 +10,18 @@ void EngineCore::Animation::animateTurntables(
 {
     auto t_0 = std::chrono::high_resolution_clock::now();
 
-    std::vector<EngineCore::Animation::TurntableComponentManager::Data> tt_cmps = turntable_mngr.getComponentDataCopy();
+    // unchanged components are shared with the previous frame instead of copied
+    auto tt_cmps = turntable_mngr.getComponentDataSnapshot();
 
-    std::vector<std::pair<size_t, size_t>> from_to_pairs;
-    size_t bucket_cnt = 6;
-    for (size_t i = 0; i < bucket_cnt; ++i) {
-        from_to_pairs.push_back({ tt_cmps.size() * (float(i) / float(bucket_cnt)), tt_cmps.size() * (float(i + 1) / float(bucket_cnt)) });
-    }
-    
-    for (auto from_to : from_to_pairs) {
-        task_scheduler.submitTask(
-            [&transform_mngr, &tt_cmps, from_to, dt]() {
-                for (size_t i = from_to.first; i < from_to.second; ++i)
-                {
-                    auto transform_idx = transform_mngr.getIndex((tt_cmps)[i].entity);
-                    transform_mngr.rotateLocal(transform_idx, glm::angleAxis(static_cast<float>((tt_cmps)[i].angle * dt), (tt_cmps)[i].axis));
-                }
+    task_scheduler.parallelFor(0, tt_cmps->size(),
+        [&transform_mngr, &tt_cmps, dt](size_t from, size_t to) {
+            for (size_t i = from; i < to; ++i)
+            {
+                auto transform_idx = transform_mngr.getIndex((*tt_cmps)[i].entity);
+                transform_mngr.rotateLocal(transform_idx, glm::angleAxis(static_cast<float>((*tt_cmps)[i].angle * dt), (*tt_cmps)[i].axis));
             }
-        );
-    }
-    
-    task_scheduler.waitWhileBusy();
+        }
+    );
 
     auto t_1 = std::chrono::high_resolution_clock::now();
 
@@ -42,9 +35,9 @@ void EngineCore::Animation::animateTagAlong(
     EngineCore::Animation::TagAlongComponentManager& tagalong_mngr,
     double dt) 
 {
-    auto tag_cmps = tagalong_mngr.getTagComponentDataCopy();
+    auto tag_cmps = tagalong_mngr.getTagComponentDataSnapshot();
 
-    for (auto& cmp : tag_cmps)
+    for (auto& cmp : *tag_cmps)
     {
         size_t target_idx = transform_mngr.getIndex(cmp.target);
         Mat4x4 target_xform = transform_mngr.getWorldTransformation(target_idx);
@@ -98,44 +91,62 @@ void EngineCore::Animation::animatioMoveTo(
     double dt,
     Utility::TaskScheduler& task_scheduler)
 {
-    size_t component_cnt = moveto_mngr.getComponentCount();
-
-    std::vector<std::pair<size_t, size_t>> from_to_pairs;
-    size_t bucket_cnt = 6;
-    for (size_t i = 0; i < bucket_cnt; ++i) {
-        from_to_pairs.push_back({ component_cnt * (float(i) / float(bucket_cnt)), component_cnt * (float(i + 1) / float(bucket_cnt)) });
-    }
-
-    for (auto from_to : from_to_pairs) {
-        task_scheduler.submitTask(
-            [&transform_mngr, &moveto_mngr, from_to, dt]() {
-                for (size_t i = from_to.first; i < from_to.second; ++i)
-                {
-                    if (moveto_mngr.checkComponent(i)) {
-                        auto const& cmp = moveto_mngr.getComponent(i);
-
-                        auto transform_idx = transform_mngr.getIndex(cmp.entity);
-
-                        if (cmp.move_orientation == MoveToComponentManager::Space::LOCAL)
+    size_t page_cnt = moveto_mngr.getComponentPageCount();
+
+    // parallelize over component pages, each page only visits its live components
+    task_scheduler.parallelFor(0, page_cnt,
+        [&transform_mngr, &moveto_mngr, dt](size_t from, size_t to) {
+            moveto_mngr.forEachComponent(from, to,
+                [&transform_mngr, dt](size_t, MoveToComponentManager::Data const& cmp) {
+                    auto transform_idx = transform_mngr.getIndex(cmp.entity);
+
+                    if (cmp.move_orientation == MoveToComponentManager::Space::LOCAL)
+                    {
+                        auto current_position = transform_mngr.getPosition(transform_idx);
+                        auto move_direction = cmp.target_position - current_position;
+                        auto distance = glm::length(move_direction);
+                        if (distance > std::numeric_limits<float>::epsilon())
                         {
-                            auto current_position = transform_mngr.getPosition(transform_idx);
-                            auto move_direction = cmp.target_position - current_position;
-                            auto distance = glm::length(move_direction);
-                            if (distance > std::numeric_limits<float>::epsilon())
-                            {
-                                move_direction /= distance;
-                                transform_mngr.translate(transform_idx, move_direction * std::min(distance, static_cast<float>(cmp.speed * dt)));
-                            }
-                        }
-                        else
-                        {
-                            //TODO
+                            move_direction /= distance;
+                            transform_mngr.translate(transform_idx, move_direction * std::min(distance, static_cast<float>(cmp.speed * dt)));
                         }
                     }
+                    else
+                    {
+                        //TODO
+                    }
                 }
-            }
-        );
-    }
+            );
+        },
+        1
+    );
+}
+
+void EngineCore::Animation::addAnimationSystems(WorldState& world)
+{
+    using EngineCore::Common::TransformComponentManager;
+
+    world.add<Reads<TurntableComponentManager>, Writes<TransformComponentManager>>(
+        [](WorldState& world, double dt, Utility::TaskScheduler& task_scheduler) {
+            animateTurntables(world.get<TransformComponentManager>(), world.get<TurntableComponentManager>(), dt, task_scheduler);
+        }
+    );
+
+    world.add<Reads<TagAlongComponentManager>, Writes<TransformComponentManager>>(
+        [](WorldState& world, double dt, Utility::TaskScheduler&) {
+            animateTagAlong(world.get<TransformComponentManager>(), world.get<TagAlongComponentManager>(), dt);
+        }
+    );
 
-    task_scheduler.waitWhileBusy();
+    world.add<Reads<BillboardComponentManager>, Writes<TransformComponentManager>>(
+        [](WorldState& world, double dt, Utility::TaskScheduler&) {
+            animateBillboards(world.get<TransformComponentManager>(), world.get<BillboardComponentManager>(), dt);
+        }
+    );
+
+    world.add<Reads<MoveToComponentManager>, Writes<TransformComponentManager>>(
+        [](WorldState& world, double dt, Utility::TaskScheduler& task_scheduler) {
+            animatioMoveTo(world.get<TransformComponentManager>(), world.get<MoveToComponentManager>(), dt, task_scheduler);
+        }
+    );
 }
@@ -9,6 +9,9 @@
 #include "TurntableComponentManager.hpp"
 
 namespace EngineCore {
+
+class WorldState;
+
 namespace Animation {
 
     void animateTurntables(
@@ -32,6 +35,12 @@ namespace Animation {
         EngineCore::Animation::MoveToComponentManager& moveto_mngr,
         double dt,
         Utility::TaskScheduler& task_scheduler);
+
+    /**
+     * Add the turntable, tag-along, billboard and move-to systems to the world, each declaring the component managers
+     * it reads and writes (see WorldState::runSystems). The world needs all component managers the systems use.
+     */
+    void addAnimationSystems(WorldState& world);
 }
 }
 
@@ -72,6 +72,8 @@ namespace Graphics {
             float min_altitude,
             float max_altitude);
 
+        void deleteComponents(std::span<Entity const> entities) override;
+
         uint getComponentCount() { return m_data.used; }
 
         void setBetaR(uint index, Vec3 const& beta_r);
@@ -268,6 +270,27 @@ namespace Graphics {
         //  GEngineCore::renderingPipeline().addSingleExecutionGpuTask([this, index] { this->computeIrradianceSingle(index); });
     }
 
+    inline void AtmosphereComponentManager::deleteComponents(std::span<Entity const> entities)
+    {
+        std::unique_lock<std::shared_mutex> lock(m_data_access_mutex);
+
+        m_data.used = static_cast<uint>(compactComponents(entities, m_data.used,
+            [this](size_t index) { return m_data.entity[index]; },
+            [this](size_t src_index, size_t dst_index) {
+                m_data.entity[dst_index] = m_data.entity[src_index];
+                m_data.beta_r[dst_index] = m_data.beta_r[src_index];
+                m_data.beta_m[dst_index] = m_data.beta_m[src_index];
+                m_data.h_r[dst_index] = m_data.h_r[src_index];
+                m_data.h_m[dst_index] = m_data.h_m[src_index];
+                m_data.min_altitude[dst_index] = m_data.min_altitude[src_index];
+                m_data.max_altitude[dst_index] = m_data.max_altitude[src_index];
+                m_data.transmittance_lut[dst_index] = m_data.transmittance_lut[src_index];
+                m_data.mie_inscatter_lut[dst_index] = m_data.mie_inscatter_lut[src_index];
+                m_data.rayleigh_inscatter_lut[dst_index] = m_data.rayleigh_inscatter_lut[src_index];
+                m_data.irradiance_lut[dst_index] = m_data.irradiance_lut[src_index];
+            }));
+    }
+
     inline void AtmosphereComponentManager::setBetaR(uint index, Vec3 const& beta_r)
     {
         std::unique_lock<std::shared_mutex> lock(m_data_access_mutex);
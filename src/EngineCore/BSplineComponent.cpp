@@ -74,6 +74,13 @@ void EngineCore::Common::BSplineComponentManager::addComponent(Entity entity, st
     }
 }
 
+void EngineCore::Common::BSplineComponentManager::deleteComponents(std::span<Entity const> entities)
+{
+    std::unique_lock<std::shared_mutex> lock(m_data_mutex);
+
+    eraseComponents(entities, m_data);
+}
+
 void EngineCore::Common::BSplineComponentManager::insertControlVertex(size_t component_idx, ControlVertex insert_location, ControlVertex control_vertex, bool insert_after)
 {
     assert(component_idx < m_data.size());
@@ -43,6 +43,8 @@ namespace Common {
         void addComponent(Entity entity);
     
         void addComponent(Entity entity, std::vector<ControlVertex> const& control_vertices);
+
+        void deleteComponents(std::span<Entity const> entities) override;
     
         /**
         * Insert a new control vertex to a specified location in the control vertex array of the specified spline curve
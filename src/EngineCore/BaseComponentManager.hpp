@@ -8,6 +8,7 @@
 
 #include <assert.h>
 #include <shared_mutex>
+#include <span>
 #include <unordered_map>
 
 #include "EntityManager.hpp"
@@ -20,12 +21,30 @@ namespace EngineCore
     protected:
     public:
         BaseComponentManager() = default;
-        ~BaseComponentManager() = default;
+        virtual ~BaseComponentManager() = default;
 
         BaseComponentManager(const BaseComponentManager& cpy) = delete;
         BaseComponentManager(BaseComponentManager&& other) = delete;
         BaseComponentManager& operator=(BaseComponentManager&& rhs) = delete;
         BaseComponentManager& operator=(const BaseComponentManager& rhs) = delete;
+
+        /**
+         * Remove all components of the given entities, called with the batch of destroyed entities
+         * at the frame boundary. Entities without components have to be ignored.
+         */
+        virtual void deleteComponents(std::span<Entity const> entities) = 0;
+
+        /**
+         * Apply the structural changes (component additions and removals) recorded into the manager's
+         * command buffers since the last call. Called at the frame boundary, managers without command buffers ignore it.
+         */
+        virtual void applyCommandBuffers() {}
+
+        /**
+         * Update state derived from changes made during the frame, e.g. world transforms from local transforms.
+         * Called at the frame boundary after all systems ran, managers without derived state ignore it.
+         */
+        virtual void propagateChanges() {}
     };
 
 }
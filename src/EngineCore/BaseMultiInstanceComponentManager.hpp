@@ -8,10 +8,13 @@
 
 #include <assert.h>
 #include <shared_mutex>
+#include <span>
 #include <unordered_map>
+#include <vector>
 
 #include "BaseComponentManager.hpp"
 #include "EntityManager.hpp"
+#include "MultiInstanceIndexMap.hpp"
 
 namespace EngineCore
 {
@@ -21,50 +24,109 @@ namespace EngineCore
     protected:
 
         /// <summary>
-        /// Mapping from Entity ID to component index
+        /// Mapping from Entity ID to component indices, lock-free for readers
         /// </summary>
-        std::unordered_map<unsigned int, std::vector<size_t>> m_index_map;
+        Utility::MultiInstanceIndexMap m_index_map;
+
+        inline void addIndex(unsigned int entity_id, size_t index)
+        {
+            m_index_map.addIndex(entity_id, index);
+        }
+
+        inline void addIndices(std::span<unsigned int const> entity_ids, std::span<size_t const> indices)
+        {
+            m_index_map.addIndices(entity_ids, indices);
+        }
+
+        inline void removeIndices(std::span<Entity const> entities)
+        {
+            std::vector<unsigned int> entity_ids;
+            entity_ids.reserve(entities.size());
+
+            for (auto entity : entities) {
+                entity_ids.push_back(entity.id());
+            }
+
+            m_index_map.removeIndices(entity_ids);
+        }
 
         /// <summary>
-        /// Mutex for protection of index map add vs read
+        /// Move the indices after the component data was reordered, see MultiInstanceIndexMap::remap
         /// </summary>
-        mutable std::shared_mutex m_index_map_mutex;
-
-        inline void addIndex(unsigned int entity_id, size_t index)
+        inline void remapIndices(std::span<size_t const> new_indices)
         {
-            std::unique_lock<std::shared_mutex> index_map_lock(m_index_map_mutex);
+            m_index_map.remap(new_indices);
+        }
 
-            auto query = m_index_map.find(entity_id);
+        /// <summary>
+        /// Remove the components of the given entities and compact the remaining components, keeping their order.
+        /// move_component(src_index, dst_index) has to move the data of a remaining component, afterwards the caller
+        /// shrinks its storage to the returned number of components. Entities without components are ignored.
+        /// </summary>
+        template<typename MoveFunction>
+        inline size_t compactComponents(std::span<Entity const> entities, size_t component_cnt, MoveFunction&& move_component)
+        {
+            std::vector<size_t> new_indices(component_cnt, 0);
+            bool any_removed = false;
 
-            if (query != m_index_map.end())
+            for (auto entity : entities)
             {
-                query->second.push_back(index);
+                for (auto index : getIndex(entity))
+                {
+                    if (index < component_cnt) {
+                        new_indices[index] = Utility::MultiInstanceIndexMap::invalid_index;
+                        any_removed = true;
+                    }
+                }
+            }
+
+            if (!any_removed) {
+                return component_cnt;
             }
-            else
+
+            size_t dst_index = 0;
+            for (size_t index = 0; index < component_cnt; ++index)
             {
-                m_index_map.insert({ entity_id, {index} });
+                if (new_indices[index] == Utility::MultiInstanceIndexMap::invalid_index) {
+                    continue;
+                }
+
+                if (dst_index != index) {
+                    move_component(index, dst_index);
+                }
+
+                new_indices[index] = dst_index++;
             }
+
+            remapIndices(new_indices);
+
+            return dst_index;
         }
 
+        /// <summary>
+        /// compactComponents for component data stored as vector of structs
+        /// </summary>
         template<typename ComponentDataStorageType>
-        inline void rebuildIndexMap(ComponentDataStorageType data)
+        inline void eraseComponents(std::span<Entity const> entities, ComponentDataStorageType& data)
         {
-            std::unique_lock<std::shared_mutex> index_map_lock(m_index_map_mutex);
+            size_t remaining_cnt = compactComponents(entities, data.size(), [&data](size_t src_index, size_t dst_index) {
+                data[dst_index] = std::move(data[src_index]);
+            });
 
-            m_index_map.clear();
+            data.erase(data.begin() + remaining_cnt, data.end());
+        }
 
-            for (size_t idx = 0; idx < data.size(); ++idx) {
-                auto query = m_index_map.find(data[idx].entity.id());
+        template<typename ComponentDataStorageType>
+        inline void rebuildIndexMap(ComponentDataStorageType const& data)
+        {
+            std::vector<unsigned int> entity_ids;
+            entity_ids.reserve(data.size());
 
-                if (query != m_index_map.end())
-                {
-                    query->second.push_back(idx);
-                }
-                else
-                {
-                    m_index_map.insert({ data[idx].entity.id(), {idx}});
-                }
+            for (size_t idx = 0; idx < data.size(); ++idx) {
+                entity_ids.push_back(data[idx].entity.id());
             }
+
+            m_index_map.rebuild(entity_ids);
         }
 
     public:
@@ -76,26 +138,41 @@ namespace EngineCore
         BaseMultiInstanceComponentManager& operator=(BaseMultiInstanceComponentManager&& rhs) = delete;
         BaseMultiInstanceComponentManager& operator=(const BaseMultiInstanceComponentManager& rhs) = delete;
 
-        inline std::vector<size_t> getIndex(Entity entity) const
+        /// <summary>
+        /// Indices of all components of the entity, without allocating or locking
+        /// </summary>
+        inline Utility::MultiInstanceIndexMap::IndexRange getIndex(Entity entity) const
         {
             return getIndex(entity.id());
         }
 
-        inline std::vector<size_t> getIndex(unsigned int entity_id) const
+        inline Utility::MultiInstanceIndexMap::IndexRange getIndex(unsigned int entity_id) const
         {
-            std::shared_lock<std::shared_mutex> index_map_lock(m_index_map_mutex);
-
-            //std::vector<size_t> retval;
+            return m_index_map.getIndex(entity_id);
+        }
 
-            auto query = m_index_map.find(entity_id);
+        /// <summary>
+        /// Indices of the components of several entities at once, ranges[i] receives the result for entity_ids[i]
+        /// </summary>
+        inline void getIndices(std::span<unsigned int const> entity_ids, std::span<Utility::MultiInstanceIndexMap::IndexRange> ranges) const
+        {
+            m_index_map.getIndices(entity_ids, ranges);
+        }
 
-            if (query != m_index_map.end())
-            {
-                return query->second;
-            }
+        /// <summary>
+        /// Number of entities with at least one component
+        /// </summary>
+        inline size_t getEntityCount() const
+        {
+            return m_index_map.getEntityCount();
+        }
 
-            //return std::move(retval);
-            return std::vector<size_t>();
+        /// <summary>
+        /// Append the ids of all entities with at least one component
+        /// </summary>
+        inline void getEntityIds(std::vector<unsigned int>& entity_ids) const
+        {
+            m_index_map.getEntityIds(entity_ids);
         }
     };
 
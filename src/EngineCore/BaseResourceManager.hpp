@@ -14,7 +14,7 @@
 #include <vector>
 
 #include "GenericVertexLayout.hpp"
-#include "MTQueue.hpp"
+#include "MPMCQueue.hpp"
 
 namespace EngineCore
 {
@@ -89,11 +89,19 @@ namespace EngineCore
 
             virtual void clearAllResources() = 0;
 
+            /**
+             * Execute the render thread tasks queued at the time of the call. Tasks queued meanwhile,
+             * e.g. by the executed tasks themselves, are left for the next call.
+             */
             void executeRenderThreadTasks() {
-                while (!m_renderThread_tasks.empty())
+                m_renderThread_tasks.drain(m_renderThread_batch);
+
+                for (auto& task : m_renderThread_batch)
                 {
-                    m_renderThread_tasks.pop()();
+                    task();
                 }
+
+                m_renderThread_batch.clear();
             }
 
             WeakResource<Buffer> getBufferResource(ResourceID rsrc_id);
@@ -156,7 +164,10 @@ namespace EngineCore
             mutable std::mutex m_rsrcID_mutex;
 
             /** Queue for exection of stuff on the render thread. */
-            EngineCore::Utility::MTQueue<std::function<void()>> m_renderThread_tasks;
+            EngineCore::Utility::MPMCQueue<std::function<void()>> m_renderThread_tasks;
+
+            /** Batch of render thread tasks currently being executed, kept as member to reuse its storage. */
+            std::vector<std::function<void()>> m_renderThread_batch;
 
             /*
              * The following collections contain all resources that are managed by an instance of a resource manager.
@@ -8,7 +8,9 @@
 
 #include <assert.h>
 #include <shared_mutex>
+#include <span>
 #include <unordered_map>
+#include <vector>
 
 #include "BaseComponentManager.hpp"
 #include "EntityManager.hpp"
@@ -28,6 +30,81 @@ namespace EngineCore
             index_map_.addIndex(entity_id, index);
         }
 
+        inline void addIndices(std::span<unsigned int const> entity_ids, std::span<size_t const> indices)
+        {
+            index_map_.addIndices(entity_ids, indices);
+        }
+
+        inline void removeIndex(unsigned int entity_id)
+        {
+            index_map_.removeIndex(entity_id);
+        }
+
+        /**
+         * Remove the components of the given entities and compact the remaining components, keeping their order.
+         * move_component(src_index, dst_index) has to move the data of a remaining component and get_entity(index)
+         * returns the entity owning a component. Afterwards, the caller shrinks its storage to the returned number
+         * of components. Entities without component are ignored.
+         */
+        template<typename EntityFunction, typename MoveFunction>
+        inline size_t compactComponents(std::span<Entity const> entities, size_t component_cnt, EntityFunction&& get_entity, MoveFunction&& move_component)
+        {
+            std::vector<bool> removed(component_cnt, false);
+            bool any_removed = false;
+
+            for (auto entity : entities)
+            {
+                size_t index = getIndex(entity);
+
+                if (index < component_cnt) {
+                    removed[index] = true;
+                    any_removed = true;
+                    removeIndex(entity.id());
+                }
+            }
+
+            if (!any_removed) {
+                return component_cnt;
+            }
+
+            std::vector<unsigned int> moved_entity_ids;
+            std::vector<size_t> moved_indices;
+
+            size_t dst_index = 0;
+            for (size_t index = 0; index < component_cnt; ++index)
+            {
+                if (removed[index]) {
+                    continue;
+                }
+
+                if (dst_index != index)
+                {
+                    move_component(index, dst_index);
+                    moved_entity_ids.push_back(get_entity(dst_index).id());
+                    moved_indices.push_back(dst_index);
+                }
+
+                ++dst_index;
+            }
+
+            addIndices(moved_entity_ids, moved_indices);
+
+            return dst_index;
+        }
+
+        /**
+         * compactComponents for component data stored as vector of structs with an entity member
+         */
+        template<typename ComponentDataStorageType>
+        inline void eraseComponents(std::span<Entity const> entities, ComponentDataStorageType& data)
+        {
+            size_t remaining_cnt = compactComponents(entities, data.size(),
+                [&data](size_t index) { return data[index].entity; },
+                [&data](size_t src_index, size_t dst_index) { data[dst_index] = std::move(data[src_index]); });
+
+            data.erase(data.begin() + remaining_cnt, data.end());
+        }
+
     public:
         BaseSingleInstanceComponentManager() = default;
         ~BaseSingleInstanceComponentManager() = default;
@@ -46,6 +123,39 @@ namespace EngineCore
         {
             return index_map_.getIndex(entity_id);
         }
+
+        /**
+         * Look up the component indices of several entities at once, entities without component get the maximum size_t value.
+         */
+        inline void getIndices(std::span<Entity const> entities, std::span<size_t> indices) const
+        {
+            assert(indices.size() >= entities.size());
+
+            for (size_t i = 0; i < entities.size(); ++i) {
+                indices[i] = index_map_.getIndex(entities[i].id());
+            }
+        }
+
+        inline void getIndices(std::span<unsigned int const> entity_ids, std::span<size_t> indices) const
+        {
+            index_map_.getIndices(entity_ids, indices);
+        }
+
+        /**
+         * Number of entities with a component.
+         */
+        inline size_t getEntityCount() const
+        {
+            return index_map_.getEntityCount();
+        }
+
+        /**
+         * Append the ids of all entities with a component.
+         */
+        inline void getEntityIds(std::vector<unsigned int>& entity_ids) const
+        {
+            index_map_.getEntityIds(entity_ids);
+        }
     };
 
 }
@@ -16,6 +16,13 @@ void BillboardComponentManager::addComponent(Entity entity, Entity target)
     m_billboard_data.push_back(Data(entity, target));
 }
 
+void BillboardComponentManager::deleteComponents(std::span<Entity const> entities)
+{
+    std::unique_lock<std::shared_mutex> lock(m_billboard_data_access_mutex);
+
+    eraseComponents(entities, m_billboard_data);
+}
+
 std::vector<BillboardComponentManager::Data> BillboardComponentManager::getBillboardComponentDataCopy()
 {
     std::vector<BillboardComponentManager::Data> retval;
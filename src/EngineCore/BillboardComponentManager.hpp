@@ -41,7 +41,7 @@ namespace EngineCore
 
             void addComponent(Entity entity, Entity target);
 
-            // TODO: deleteComponent??
+            void deleteComponents(std::span<Entity const> entities) override;
 
             std::vector<Data> getBillboardComponentDataCopy();
         };
@@ -82,7 +82,21 @@ namespace EngineCore
 
         void BoundingBoxComponentManager::deleteComponent(Entity entity)
         {
-            // std::unique_lock<std::shared_mutex> lock(m_data_access_mutex);
+            deleteComponents(std::span<Entity const>(&entity, 1));
+        }
+
+        void BoundingBoxComponentManager::deleteComponents(std::span<Entity const> entities)
+        {
+            std::unique_lock<std::shared_mutex> lock(m_data_access_mutex);
+
+            m_data.used = static_cast<uint>(compactComponents(entities, m_data.used,
+                [this](size_t src_index, size_t dst_index) {
+                    m_data.entity[dst_index] = m_data.entity[src_index];
+                    m_data.width[dst_index] = m_data.width[src_index];
+                    m_data.height[dst_index] = m_data.height[src_index];
+                    m_data.depth[dst_index] = m_data.depth[src_index];
+                    m_data.alignment[dst_index] = m_data.alignment[src_index];
+                }));
         }
 
         uint BoundingBoxComponentManager::getComponentCount() const
@@ -22,6 +22,8 @@ namespace EngineCore
 
             void deleteComponent(Entity entity);
 
+            void deleteComponents(std::span<Entity const> entities) override;
+
             uint getComponentCount() const;
 
             Entity getEntity(uint index) const;
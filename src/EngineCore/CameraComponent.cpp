@@ -94,17 +94,35 @@ namespace EngineCore
 
         void CameraComponentManager::deleteComponent(Entity entity)
         {
-            // std::unique_lock<std::shared_mutex> lock(m_data_access_mutex);
+            deleteComponents(std::span<Entity const>(&entity, 1));
         }
 
-        bool CameraComponentManager::checkComponent(uint entity_id) const
+        void CameraComponentManager::deleteComponents(std::span<Entity const> entities)
         {
-            auto search = m_index_map.find(entity_id);
+            std::unique_lock<std::shared_mutex> lock(m_data_access_mutex);
+
+            m_data.used = static_cast<uint>(compactComponents(entities, m_data.used,
+                [this](size_t src_index, size_t dst_index) {
+                    m_data.entity[dst_index] = m_data.entity[src_index];
+                    m_data.near_cp[dst_index] = m_data.near_cp[src_index];
+                    m_data.far_cp[dst_index] = m_data.far_cp[src_index];
+                    m_data.fovy[dst_index] = m_data.fovy[src_index];
+                    m_data.aspect_ratio[dst_index] = m_data.aspect_ratio[src_index];
+                    m_data.exposure[dst_index] = m_data.exposure[src_index];
+                    m_data.projection_matrix[dst_index] = m_data.projection_matrix[src_index];
+                }));
+
+            for (auto entity : entities)
+            {
+                if (entity == m_active_camera) {
+                    m_active_camera = EntityManager::invalidEntity();
+                }
+            }
+        }
 
-            if (search == m_index_map.end())
-                return false;
-            else
-                return true;
+        bool CameraComponentManager::checkComponent(uint entity_id) const
+        {
+            return !getIndex(entity_id).empty();
         }
 
         void CameraComponentManager::setActiveCamera(Entity entity)
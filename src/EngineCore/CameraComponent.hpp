@@ -50,6 +50,8 @@ namespace EngineCore
 
             void deleteComponent(Entity entity);
 
+            void deleteComponents(std::span<Entity const> entities) override;
+
             bool checkComponent(uint entity_id) const;
 
             void setActiveCamera(Entity entity);
@@ -0,0 +1,112 @@
+#ifndef CommandBuffer_hpp
+#define CommandBuffer_hpp
+
+#include <algorithm>
+#include <atomic>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace EngineCore {
+    namespace Utility {
+
+        /**
+         * Records commands, e.g. structural changes to a component manager, from any number of threads without contention.
+         * Every thread appends to a buffer of its own, all buffers are drained together by take.
+         */
+        template<typename Command>
+        class CommandBuffer
+        {
+        public:
+            CommandBuffer() : id_(next_id_.fetch_add(1, std::memory_order_relaxed)) {}
+            ~CommandBuffer() = default;
+
+            CommandBuffer(CommandBuffer const& cpy) = delete;
+            CommandBuffer& operator=(CommandBuffer const& rhs) = delete;
+
+            /**
+             * Append the command to the calling thread's buffer. Locks the thread's buffer,
+             * which is only contended while take steals it.
+             */
+            void record(Command command);
+
+            /**
+             * Move all recorded commands to the end of commands, thread by thread and in order of recording per thread.
+             * May run concurrently to record, commands recorded meanwhile are either taken now or by the next call.
+             */
+            void take(std::vector<Command>& commands);
+
+        private:
+            struct ThreadBuffer
+            {
+                std::vector<Command> commands;
+                std::mutex           mutex;
+            };
+
+            ThreadBuffer& getThreadBuffer();
+
+            /** Ids are never reused, so a thread never mistakes a new command buffer for a destroyed one */
+            static inline std::atomic_size_t next_id_ = 0;
+
+            size_t                                             id_;
+            std::vector<std::unique_ptr<ThreadBuffer>> buffers_;
+            std::mutex                                 mutex_;
+        };
+
+        template<typename Command>
+        inline void CommandBuffer<Command>::record(Command command)
+        {
+            ThreadBuffer& buffer = getThreadBuffer();
+
+            std::unique_lock<std::mutex> lock(buffer.mutex);
+            buffer.commands.push_back(std::move(command));
+        }
+
+        template<typename Command>
+        inline void CommandBuffer<Command>::take(std::vector<Command>& commands)
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+
+            // a thread's buffer is swapped with an empty one, so recording only waits for the swap, not for the copy.
+            // The empty buffer keeps the capacity of the previously stolen one, recording volume tends to be similar per thread.
+            std::vector<Command> stolen;
+
+            for (auto& buffer : buffers_)
+            {
+                {
+                    std::unique_lock<std::mutex> buffer_lock(buffer->mutex);
+                    std::swap(buffer->commands, stolen);
+                }
+
+                std::move(stolen.begin(), stolen.end(), std::back_inserter(commands));
+                stolen.clear();
+            }
+        }
+
+        template<typename Command>
+        inline typename CommandBuffer<Command>::ThreadBuffer& CommandBuffer<Command>::getThreadBuffer()
+        {
+            // buffers of the calling thread by command buffer id
+            thread_local std::vector<ThreadBuffer*> thread_buffers;
+
+            if (id_ < thread_buffers.size() && thread_buffers[id_] != nullptr) {
+                return *thread_buffers[id_];
+            }
+
+            std::unique_lock<std::mutex> lock(mutex_);
+
+            buffers_.push_back(std::make_unique<ThreadBuffer>());
+
+            if (thread_buffers.size() <= id_) {
+                thread_buffers.resize(id_ + 1, nullptr);
+            }
+            thread_buffers[id_] = buffers_.back().get();
+
+            return *thread_buffers[id_];
+        }
+
+    }
+}
+
+#endif // !CommandBuffer_hpp
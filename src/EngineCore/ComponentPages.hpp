@@ -0,0 +1,468 @@
+#ifndef ComponentPages_hpp
+#define ComponentPages_hpp
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cassert>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <shared_mutex>
+#include <utility>
+#include <vector>
+
+namespace EngineCore {
+    namespace Utility {
+
+        /**
+         * Page, slot and version bookkeeping shared by ComponentStorage and SoAComponentStorage.
+         * Components live in slots of fixed size pages that are allocated on first use. Every page tracks which of its
+         * slots hold live components and the version of the last change per slot. Slots of deleted components are reused.
+         * How the components of a page are stored is up to the derived storage, i.e. the PageStorage type,
+         * which is default constructed when a page is allocated.
+         */
+        template<typename PageStorage, size_t PageCount, size_t PageSize>
+        class ComponentPages
+        {
+        public:
+            constexpr size_t getPageCount();
+
+            constexpr size_t getPageSize();
+
+            /**
+             * Number of component slots in use so far, including slots of deleted components.
+             * Valid component indices are in [0, getComponentCount()).
+             */
+            size_t getComponentCount() const;
+
+            /**
+             * Number of pages covering all component slots in use so far, i.e. the page range for forEachPage.
+             */
+            size_t getUsedPageCount() const;
+
+            /**
+             * Version stamped on components that change from now on. Starts at 1, i.e. all components are changed since version 0.
+             */
+            uint64_t getVersion() const;
+
+            /**
+             * Close the current version, later changes are stamped with the next one. Changes concurrent to this call
+             * may end up in either version, so consumers that need exact deltas call it at a sync point.
+             * \return Returns the closed version, i.e. a consumer passes it to its next forEachChangedSince.
+             */
+            uint64_t advanceVersion();
+
+            /**
+             * Stamp the component with the current version. Additions are stamped automatically,
+             * modifications through references have to be marked by the caller.
+             */
+            void markChanged(size_t page_index, size_t index_in_page);
+
+            uint64_t getChangeVersion(size_t page_index, size_t index_in_page) const;
+
+            /**
+             * Live bits of the slots [64 * word_index, 64 * word_index + 64) of the given page, bit i set for live slots.
+             */
+            uint64_t getLiveWord(size_t page_index, size_t word_index) const;
+
+            bool checkComponent(size_t page_index, size_t index_in_page) const;
+
+            /**
+             * Check if the page is allocated, i.e. holds storage for its components.
+             */
+            bool checkPage(size_t page_index) const;
+
+            std::pair<size_t, size_t> getIndices(size_t component_index) const;
+
+            std::unique_lock<std::shared_mutex> accquirePageLock(size_t page_index) const;
+
+        protected:
+            ComponentPages();
+            ~ComponentPages() = default;
+
+            /**
+             * Take a slot, reusing free slots first, and let write(page_storage, index_in_page) fill it.
+             */
+            template<typename WriteFunction>
+            size_t addSlot(WriteFunction&& write);
+
+            /**
+             * Take cnt slots at once and let write(page_storage, index_in_page, i, component_index) fill the i-th.
+             * Free slots are reused first, the remaining components get a contiguous range of fresh slots.
+             * Takes the storage lock once and the lock of each touched page once.
+             * The indices of the new components are appended to component_indices, in order.
+             */
+            template<typename WriteFunction>
+            void addSlots(size_t cnt, WriteFunction&& write, std::vector<size_t>& component_indices);
+
+            /**
+             * Mark the slot as dead, let reset(page_storage, index_in_page) release the component's data and put the slot on the free list.
+             */
+            template<typename ResetFunction>
+            void deleteSlot(size_t component_index, ResetFunction&& reset);
+
+            /**
+             * Call fn(component_index, page_index, index_in_page) for the live slots of the page range,
+             * only for those changed after changed_since unless it is 0.
+             */
+            template<typename Function>
+            void visitLiveSlots(size_t page_begin, size_t page_end, uint64_t changed_since, Function& fn) const;
+
+            PageStorage& getPageStorage(size_t page_index);
+
+            PageStorage const& getPageStorage(size_t page_index) const;
+
+        private:
+            static constexpr size_t live_word_cnt_ = (PageSize + 63) / 64;
+
+            struct Page
+            {
+                std::unique_ptr<PageStorage>                 storage;
+                /** One bit per slot, set while the slot holds a live component */
+                std::unique_ptr<std::atomic<uint64_t>[]>     live_bits;
+                /** Version of the last change per slot */
+                std::unique_ptr<std::atomic<uint64_t>[]>     changed_versions;
+                /** Latest change version of any slot, for skipping unchanged pages */
+                std::atomic<uint64_t>                        changed_version = 0;
+                /** Set once all of the above are allocated, checked with acquire by readers not holding the page lock */
+                std::atomic<bool>                            allocated = false;
+                mutable std::shared_mutex                    mutex;
+            };
+
+            /** Allocate the page's storage if it is not allocated yet, the page has to be locked */
+            static void allocatePage(Page& page);
+
+            static void stamp(Page& page, size_t index_in_page, uint64_t version);
+
+            /** Mark the slot live and stamp it, the page has to be locked */
+            static void publishSlot(Page& page, size_t index_in_page, uint64_t version);
+
+            std::vector<Page>  pages_;
+            std::queue<size_t> free_list_;
+
+            std::mutex         add_component_mutex_;
+            std::atomic_size_t component_cnt_ = std::atomic_size_t{ 0 };
+
+            std::atomic<uint64_t> version_ = 1;
+        };
+
+        template<typename PageStorage, size_t PageCount, size_t PageSize>
+        inline ComponentPages<PageStorage, PageCount, PageSize>::ComponentPages()
+            : pages_(PageCount)
+        {
+        }
+
+        template<typename PageStorage, size_t PageCount, size_t PageSize>
+        inline constexpr size_t ComponentPages<PageStorage, PageCount, PageSize>::getPageCount()
+        {
+            return PageCount;
+        }
+
+        template<typename PageStorage, size_t PageCount, size_t PageSize>
+        inline constexpr size_t ComponentPages<PageStorage, PageCount, PageSize>::getPageSize()
+        {
+            return PageSize;
+        }
+
+        template<typename PageStorage, size_t PageCount, size_t PageSize>
+        template<typename WriteFunction>
+        inline size_t ComponentPages<PageStorage, PageCount, PageSize>::addSlot(WriteFunction&& write)
+        {
+            std::unique_lock<std::mutex> lock(add_component_mutex_);
+
+            size_t component_cnt = component_cnt_.load();
+            size_t component_index;
+
+            // check for free component slots to overwrite
+            if (!free_list_.empty())
+            {
+                component_index = free_list_.front();
+                free_list_.pop();
+            }
+            else
+            {
+                component_index = component_cnt;
+            }
+
+            auto [page_index, index_in_page] = getIndices(component_index);
+            assert(page_index < PageCount); // TODO handle full storage with exception?
+            assert(index_in_page < PageSize);
+
+            auto& page = pages_[page_index];
+
+            std::unique_lock<std::shared_mutex> page_lock(page.mutex);
+
+            allocatePage(page);
+
+            write(*page.storage, index_in_page);
+            publishSlot(page, index_in_page, version_.load(std::memory_order_relaxed));
+
+            // if component slot was not re-used, increment component count
+            if (component_index == component_cnt) {
+                ++component_cnt_;
+            }
+
+            return component_index;
+        }
+
+        template<typename PageStorage, size_t PageCount, size_t PageSize>
+        template<typename WriteFunction>
+        inline void ComponentPages<PageStorage, PageCount, PageSize>::addSlots(size_t cnt, WriteFunction&& write, std::vector<size_t>& component_indices)
+        {
+            std::unique_lock<std::mutex> lock(add_component_mutex_);
+
+            size_t first = component_indices.size();
+            component_indices.reserve(first + cnt);
+
+            while (component_indices.size() - first < cnt && !free_list_.empty())
+            {
+                component_indices.push_back(free_list_.front());
+                free_list_.pop();
+            }
+
+            size_t component_cnt = component_cnt_.load();
+            size_t fresh_cnt = cnt - (component_indices.size() - first);
+
+            assert((component_cnt + fresh_cnt + PageSize - 1) / PageSize <= PageCount);
+
+            for (size_t i = 0; i < fresh_cnt; ++i) {
+                component_indices.push_back(component_cnt + i);
+            }
+
+            uint64_t version = version_.load(std::memory_order_relaxed);
+
+            // consecutive slots mostly share a page, so each page is locked once per run of slots
+            size_t i = 0;
+            while (i < cnt)
+            {
+                size_t page_index = component_indices[first + i] / PageSize;
+                auto& page = pages_[page_index];
+
+                std::unique_lock<std::shared_mutex> page_lock(page.mutex);
+
+                allocatePage(page);
+
+                for (; i < cnt && component_indices[first + i] / PageSize == page_index; ++i)
+                {
+                    size_t index_in_page = component_indices[first + i] % PageSize;
+
+                    write(*page.storage, index_in_page, i, component_indices[first + i]);
+                    publishSlot(page, index_in_page, version);
+                }
+            }
+
+            component_cnt_.store(component_cnt + fresh_cnt);
+        }
+
+        template<typename PageStorage, size_t PageCount, size_t PageSize>
+        template<typename ResetFunction>
+        inline void ComponentPages<PageStorage, PageCount, PageSize>::deleteSlot(size_t component_index, ResetFunction&& reset)
+        {
+            std::unique_lock<std::mutex> lock(add_component_mutex_);
+
+            auto [page_index, index_in_page] = getIndices(component_index);
+
+            if (!checkPage(page_index)) {
+                return;
+            }
+
+            auto& page = pages_[page_index];
+
+            std::unique_lock<std::shared_mutex> page_lock(page.mutex);
+
+            uint64_t bit = uint64_t(1) << (index_in_page % 64);
+            uint64_t previous = page.live_bits[index_in_page / 64].fetch_and(~bit, std::memory_order_acq_rel);
+
+            // only put slots on the free list once, deleting a dead component would hand out the slot twice
+            if ((previous & bit) == 0) {
+                return;
+            }
+
+            reset(*page.storage, index_in_page);
+
+            free_list_.push(component_index);
+        }
+
+        template<typename PageStorage, size_t PageCount, size_t PageSize>
+        inline void ComponentPages<PageStorage, PageCount, PageSize>::allocatePage(Page& page)
+        {
+            if (page.allocated.load(std::memory_order_relaxed)) {
+                return;
+            }
+
+            page.storage = std::make_unique<PageStorage>();
+            page.live_bits = std::make_unique<std::atomic<uint64_t>[]>(live_word_cnt_);
+
+            for (size_t word_idx = 0; word_idx < live_word_cnt_; ++word_idx)
+            {
+                page.live_bits[word_idx].store(0, std::memory_order_relaxed);
+            }
+
+            page.changed_versions = std::make_unique<std::atomic<uint64_t>[]>(PageSize);
+
+            for (size_t idx = 0; idx < PageSize; ++idx)
+            {
+                page.changed_versions[idx].store(0, std::memory_order_relaxed);
+            }
+
+            // publish the page to readers that don't take the page lock
+            page.allocated.store(true, std::memory_order_release);
+        }
+
+        template<typename PageStorage, size_t PageCount, size_t PageSize>
+        inline void ComponentPages<PageStorage, PageCount, PageSize>::stamp(Page& page, size_t index_in_page, uint64_t version)
+        {
+            page.changed_versions[index_in_page].store(version, std::memory_order_relaxed);
+
+            // the page version only grows, even if a writer with an older version comes last
+            uint64_t page_version = page.changed_version.load(std::memory_order_relaxed);
+            while (page_version < version && !page.changed_version.compare_exchange_weak(page_version, version, std::memory_order_release, std::memory_order_relaxed)) {}
+        }
+
+        template<typename PageStorage, size_t PageCount, size_t PageSize>
+        inline void ComponentPages<PageStorage, PageCount, PageSize>::publishSlot(Page& page, size_t index_in_page, uint64_t version)
+        {
+            page.live_bits[index_in_page / 64].fetch_or(uint64_t(1) << (index_in_page % 64), std::memory_order_release);
+            stamp(page, index_in_page, version);
+        }
+
+        template<typename PageStorage, size_t PageCount, size_t PageSize>
+        inline size_t ComponentPages<PageStorage, PageCount, PageSize>::getComponentCount() const
+        {
+            return component_cnt_.load();
+        }
+
+        template<typename PageStorage, size_t PageCount, size_t PageSize>
+        inline size_t ComponentPages<PageStorage, PageCount, PageSize>::getUsedPageCount() const
+        {
+            return (component_cnt_.load() + PageSize - 1) / PageSize;
+        }
+
+        template<typename PageStorage, size_t PageCount, size_t PageSize>
+        inline uint64_t ComponentPages<PageStorage, PageCount, PageSize>::getVersion() const
+        {
+            return version_.load(std::memory_order_relaxed);
+        }
+
+        template<typename PageStorage, size_t PageCount, size_t PageSize>
+        inline uint64_t ComponentPages<PageStorage, PageCount, PageSize>::advanceVersion()
+        {
+            return version_.fetch_add(1, std::memory_order_acq_rel);
+        }
+
+        template<typename PageStorage, size_t PageCount, size_t PageSize>
+        inline void ComponentPages<PageStorage, PageCount, PageSize>::markChanged(size_t page_index, size_t index_in_page)
+        {
+            assert(pages_[page_index].allocated.load(std::memory_order_acquire));
+
+            stamp(pages_[page_index], index_in_page, version_.load(std::memory_order_relaxed));
+        }
+
+        template<typename PageStorage, size_t PageCount, size_t PageSize>
+        inline uint64_t ComponentPages<PageStorage, PageCount, PageSize>::getChangeVersion(size_t page_index, size_t index_in_page) const
+        {
+            if (!checkPage(page_index)) {
+                return 0;
+            }
+
+            return pages_[page_index].changed_versions[index_in_page].load(std::memory_order_relaxed);
+        }
+
+        template<typename PageStorage, size_t PageCount, size_t PageSize>
+        inline bool ComponentPages<PageStorage, PageCount, PageSize>::checkPage(size_t page_index) const
+        {
+            return page_index < PageCount && pages_[page_index].allocated.load(std::memory_order_acquire);
+        }
+
+        template<typename PageStorage, size_t PageCount, size_t PageSize>
+        inline uint64_t ComponentPages<PageStorage, PageCount, PageSize>::getLiveWord(size_t page_index, size_t word_index) const
+        {
+            if (!checkPage(page_index) || word_index >= live_word_cnt_) {
+                return 0;
+            }
+
+            return pages_[page_index].live_bits[word_index].load(std::memory_order_acquire);
+        }
+
+        template<typename PageStorage, size_t PageCount, size_t PageSize>
+        inline bool ComponentPages<PageStorage, PageCount, PageSize>::checkComponent(size_t page_index, size_t index_in_page) const
+        {
+            return (getLiveWord(page_index, index_in_page / 64) >> (index_in_page % 64)) & 1;
+        }
+
+        template<typename PageStorage, size_t PageCount, size_t PageSize>
+        template<typename Function>
+        inline void ComponentPages<PageStorage, PageCount, PageSize>::visitLiveSlots(size_t page_begin, size_t page_end, uint64_t changed_since, Function& fn) const
+        {
+            page_end = std::min(page_end, PageCount);
+
+            for (size_t page_index = page_begin; page_index < page_end; ++page_index)
+            {
+                auto const& page = pages_[page_index];
+
+                if (!page.allocated.load(std::memory_order_acquire)) {
+                    continue;
+                }
+
+                if (changed_since != 0 && page.changed_version.load(std::memory_order_acquire) <= changed_since) {
+                    continue;
+                }
+
+                for (size_t word_idx = 0; word_idx < live_word_cnt_; ++word_idx)
+                {
+                    uint64_t word = page.live_bits[word_idx].load(std::memory_order_acquire);
+
+                    // visit set bits only, lowest first
+                    while (word != 0)
+                    {
+                        size_t index_in_page = word_idx * 64 + static_cast<size_t>(std::countr_zero(word));
+                        word &= word - 1;
+
+                        if (changed_since != 0 && page.changed_versions[index_in_page].load(std::memory_order_relaxed) <= changed_since) {
+                            continue;
+                        }
+
+                        fn(page_index * PageSize + index_in_page, page_index, index_in_page);
+                    }
+                }
+            }
+        }
+
+        template<typename PageStorage, size_t PageCount, size_t PageSize>
+        inline PageStorage& ComponentPages<PageStorage, PageCount, PageSize>::getPageStorage(size_t page_index)
+        {
+            assert(pages_[page_index].allocated.load(std::memory_order_acquire));
+
+            return *pages_[page_index].storage;
+        }
+
+        template<typename PageStorage, size_t PageCount, size_t PageSize>
+        inline PageStorage const& ComponentPages<PageStorage, PageCount, PageSize>::getPageStorage(size_t page_index) const
+        {
+            assert(pages_[page_index].allocated.load(std::memory_order_acquire));
+
+            return *pages_[page_index].storage;
+        }
+
+        template<typename PageStorage, size_t PageCount, size_t PageSize>
+        inline std::pair<size_t, size_t> ComponentPages<PageStorage, PageCount, PageSize>::getIndices(size_t component_index) const
+        {
+            // return { page_index, index_in_page }
+            return std::pair<size_t, size_t>{component_index / PageSize, component_index % PageSize};
+        }
+
+        template<typename PageStorage, size_t PageCount, size_t PageSize>
+        inline std::unique_lock<std::shared_mutex> ComponentPages<PageStorage, PageCount, PageSize>::accquirePageLock(size_t page_index) const
+        {
+            //TODO better error handling?
+            assert(page_index < PageCount);
+
+            return std::unique_lock<std::shared_mutex>(pages_[page_index].mutex);
+        }
+
+    }
+}
+
+#endif // !ComponentPages_hpp
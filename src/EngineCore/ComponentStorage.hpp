@@ -1,193 +1,186 @@
 #ifndef ComponentStorage_hpp
 #define ComponentStorage_hpp
 
-#include <memory>
-#include <shared_mutex>
+#include <array>
+#include <cstdint>
+#include <utility>
 #include <vector>
-#include <queue>
+
+#include "ComponentPages.hpp"
 
 namespace EngineCore {
     namespace Utility {
 
+        /**
+         * Paged storage of components as structs, i.e. every page holds an array of PageSize components.
+         * Addressing of pages and slots, liveness and change versions are handled by ComponentPages.
+         */
         template<typename T, size_t PageCount, size_t PageSize>
-        class ComponentStorage
+        class ComponentStorage : public ComponentPages<std::array<T, PageSize>, PageCount, PageSize>
         {
         public:
-            ComponentStorage();
+            ComponentStorage() = default;
             ~ComponentStorage() = default;
 
-            constexpr size_t getPageCount();
-
-            constexpr size_t getPageSize();
-
             size_t addComponent(T component);
 
+            /**
+             * Add cnt components at once, make_component(i, component_index) returns the i-th component.
+             * Free slots are reused first, the remaining components get a contiguous range of fresh slots.
+             * Takes the storage lock once and the lock of each touched page once.
+             * The indices of the new components are appended to component_indices, in order.
+             */
+            template<typename Function>
+            void addComponents(size_t cnt, Function&& make_component, std::vector<size_t>& component_indices);
+
+            /**
+             * Mark the component as dead and release its data. The slot is reused by later additions.
+             */
             void deleteComponent(size_t component_index);
 
-            size_t getComponentCount() const;
+            /**
+             * Call fn(component_index, component) for every live component in the pages [page_begin, page_end).
+             * Unallocated pages and dead slots are skipped without touching the component data.
+             * Disjoint page ranges can be processed concurrently, e.g. from a TaskScheduler::parallelFor over
+             * [0, getUsedPageCount()). The storage is not locked, fn has to synchronize access itself if
+             * components are modified concurrently.
+             */
+            template<typename Function>
+            void forEachPage(size_t page_begin, size_t page_end, Function&& fn);
+
+            template<typename Function>
+            void forEachPage(size_t page_begin, size_t page_end, Function&& fn) const;
+
+            /**
+             * Call fn(component_index, component) for every live component.
+             */
+            template<typename Function>
+            void forEach(Function&& fn);
+
+            template<typename Function>
+            void forEach(Function&& fn) const;
+
+            /**
+             * Like forEachPage, but only visits live components changed after the given version.
+             * Pages without such changes are skipped as a whole. Deletions are not reported.
+             */
+            template<typename Function>
+            void forEachChangedSince(uint64_t version, size_t page_begin, size_t page_end, Function&& fn);
+
+            template<typename Function>
+            void forEachChangedSince(uint64_t version, size_t page_begin, size_t page_end, Function&& fn) const;
 
             T& operator()(size_t page_index, size_t index_in_page);
-            
+
             T const& operator()(size_t page_index, size_t index_in_page) const;
 
             T getComponentCopy(size_t component_index) const;
 
-            bool checkComponent(size_t page_index, size_t index_in_page) const;
-
-            std::pair<size_t, size_t> getIndices(size_t component_index) const;
-
-            std::unique_lock<std::shared_mutex> accquirePageLock(size_t page_index) const;
-
         private:
-            struct Page
-            {
-                std::unique_ptr<std::vector<std::pair<bool,T>>> storage;
-                mutable std::shared_mutex                       mutex;
-            };
-
-            std::vector<Page>  components_;
-            std::queue<size_t> free_list_;
-
-            std::mutex         add_component_mutex_;
-            std::atomic_size_t component_cnt_ = std::atomic_size_t{ 0 };
+            /** Visit live components of the page range, only those changed after changed_since unless it is 0 */
+            template<typename Storage, typename Function>
+            static void visitLiveComponents(Storage& storage, size_t page_begin, size_t page_end, uint64_t changed_since, Function& fn);
         };
 
         template<typename T, size_t PageCount, size_t PageSize>
-        inline ComponentStorage<T, PageCount, PageSize>::ComponentStorage()
-            : components_(PageCount)
+        inline size_t ComponentStorage<T, PageCount, PageSize>::addComponent(T component)
         {
-            for (size_t page_idx = 0; page_idx < PageCount; ++page_idx)
-            {
-                components_[page_idx].storage = nullptr;
-            }
+            return this->addSlot([&component](std::array<T, PageSize>& components, size_t index_in_page) {
+                components[index_in_page] = std::move(component);
+            });
         }
 
         template<typename T, size_t PageCount, size_t PageSize>
-        inline constexpr size_t ComponentStorage<T, PageCount, PageSize>::getPageCount()
+        template<typename Function>
+        inline void ComponentStorage<T, PageCount, PageSize>::addComponents(size_t cnt, Function&& make_component, std::vector<size_t>& component_indices)
         {
-            return PageCount;
+            this->addSlots(cnt,
+                [&make_component](std::array<T, PageSize>& components, size_t index_in_page, size_t i, size_t component_index) {
+                    components[index_in_page] = make_component(i, component_index);
+                },
+                component_indices);
         }
 
         template<typename T, size_t PageCount, size_t PageSize>
-        inline constexpr size_t ComponentStorage<T, PageCount, PageSize>::getPageSize()
+        inline void ComponentStorage<T, PageCount, PageSize>::deleteComponent(size_t component_index)
         {
-            return PageSize;
+            // release resources held by the component, e.g. captured callbacks
+            this->deleteSlot(component_index, [](std::array<T, PageSize>& components, size_t index_in_page) {
+                components[index_in_page] = T();
+            });
         }
 
         template<typename T, size_t PageCount, size_t PageSize>
-        inline size_t ComponentStorage<T, PageCount, PageSize>::addComponent(T component)
+        template<typename Function>
+        inline void ComponentStorage<T, PageCount, PageSize>::forEachPage(size_t page_begin, size_t page_end, Function&& fn)
         {
-            std::unique_lock<std::mutex> lock(add_component_mutex_);
-
-            size_t component_cnt = component_cnt_.load();
-            size_t component_index;
-
-            // check for free component slots to overwrite
-            if (!free_list_.empty())
-            {
-                component_index = free_list_.front();
-                free_list_.pop();
-            }
-            else
-            {
-                component_index = component_cnt;
-            }
-
-            auto [page_index, index_in_page] = getIndices(component_index);
-            assert(page_index < PageCount); // TODO handle full storage with exception?
-            assert(index_in_page < PageSize);
-
-            std::unique_lock<std::shared_mutex> page_lock(components_[page_index].mutex);
-
-            // check if page is allocated
-            if (components_[page_index].storage == nullptr)
-            {
-                // add new page
-                components_[page_index].storage = std::make_unique<std::vector<std::pair<bool,T>>>(PageSize);
-
-                for (auto& c : (*components_[page_index].storage))
-                {
-                    c.first = false;
-                }
-            }
-
-            // write component to page
-            components_[page_index].storage->operator[](index_in_page) = { true, std::move(component) };
-
-            // if component slot was not re-used, increment component count
-            if (component_index == component_cnt) {
-                ++component_cnt_;
-            }
-
-            return component_index;
+            visitLiveComponents(*this, page_begin, page_end, 0, fn);
         }
 
         template<typename T, size_t PageCount, size_t PageSize>
-        inline void ComponentStorage<T, PageCount, PageSize>::deleteComponent(size_t component_index)
+        template<typename Function>
+        inline void ComponentStorage<T, PageCount, PageSize>::forEachPage(size_t page_begin, size_t page_end, Function&& fn) const
         {
-            std::unique_lock<std::mutex> lock(add_component_mutex_);
-
-            free_list_.push(component_index);
-
-            // TODO actually somehow mark components as invalid?
+            visitLiveComponents(*this, page_begin, page_end, 0, fn);
         }
 
         template<typename T, size_t PageCount, size_t PageSize>
-        inline size_t ComponentStorage<T, PageCount, PageSize>::getComponentCount() const
+        template<typename Function>
+        inline void ComponentStorage<T, PageCount, PageSize>::forEach(Function&& fn)
         {
-            return component_cnt_.load();
+            visitLiveComponents(*this, 0, this->getUsedPageCount(), 0, fn);
         }
 
         template<typename T, size_t PageCount, size_t PageSize>
-        inline T& ComponentStorage<T, PageCount, PageSize>::operator()(size_t page_index, size_t index_in_page)
+        template<typename Function>
+        inline void ComponentStorage<T, PageCount, PageSize>::forEach(Function&& fn) const
         {
-            assert(components_[page_index].storage != nullptr);
-        
-            return components_[page_index].storage->operator[](index_in_page).second;
+            visitLiveComponents(*this, 0, this->getUsedPageCount(), 0, fn);
         }
-        
+
         template<typename T, size_t PageCount, size_t PageSize>
-        inline T const& ComponentStorage<T, PageCount, PageSize>::operator()(size_t page_index, size_t index_in_page) const
+        template<typename Function>
+        inline void ComponentStorage<T, PageCount, PageSize>::forEachChangedSince(uint64_t version, size_t page_begin, size_t page_end, Function&& fn)
         {
-            assert(components_[page_index].storage != nullptr);
-        
-            return components_[page_index].storage->operator[](index_in_page).second;
+            visitLiveComponents(*this, page_begin, page_end, version, fn);
         }
 
         template<typename T, size_t PageCount, size_t PageSize>
-        inline T ComponentStorage<T, PageCount, PageSize>::getComponentCopy(size_t component_index) const
+        template<typename Function>
+        inline void ComponentStorage<T, PageCount, PageSize>::forEachChangedSince(uint64_t version, size_t page_begin, size_t page_end, Function&& fn) const
         {
-            auto [page_index, index_in_page] = getIndices(component_index);
-
-            assert(components_[page_index].storage != nullptr);
-
-            return components_[page_index].storage->at(index_in_page).second;
+            visitLiveComponents(*this, page_begin, page_end, version, fn);
         }
 
         template<typename T, size_t PageCount, size_t PageSize>
-        inline bool ComponentStorage<T, PageCount, PageSize>::checkComponent(size_t page_index, size_t index_in_page) const
+        template<typename Storage, typename Function>
+        inline void ComponentStorage<T, PageCount, PageSize>::visitLiveComponents(Storage& storage, size_t page_begin, size_t page_end, uint64_t changed_since, Function& fn)
         {
-            assert(components_[page_index].storage != nullptr);
+            auto visit = [&storage, &fn](size_t component_index, size_t page_index, size_t index_in_page) {
+                fn(component_index, storage(page_index, index_in_page));
+            };
 
-            return components_[page_index].storage->operator[](index_in_page).first;
+            storage.visitLiveSlots(page_begin, page_end, changed_since, visit);
         }
 
         template<typename T, size_t PageCount, size_t PageSize>
-        inline std::unique_lock<std::shared_mutex> ComponentStorage<T, PageCount, PageSize>::accquirePageLock(size_t page_index) const
+        inline T& ComponentStorage<T, PageCount, PageSize>::operator()(size_t page_index, size_t index_in_page)
         {
-            //TODO better error handling?
-            assert(page_index < PageCount);
+            return this->getPageStorage(page_index)[index_in_page];
+        }
 
-            return std::unique_lock<std::shared_mutex>(components_[page_index].mutex);;
+        template<typename T, size_t PageCount, size_t PageSize>
+        inline T const& ComponentStorage<T, PageCount, PageSize>::operator()(size_t page_index, size_t index_in_page) const
+        {
+            return this->getPageStorage(page_index)[index_in_page];
         }
 
         template<typename T, size_t PageCount, size_t PageSize>
-        inline std::pair<size_t, size_t> ComponentStorage<T, PageCount, PageSize>::getIndices(size_t component_index) const
+        inline T ComponentStorage<T, PageCount, PageSize>::getComponentCopy(size_t component_index) const
         {
-            //auto div = std::div(static_cast<long>(component_index), static_cast<long>(PageSize));
-            // return { page_index, index_in_page }
-            //return std::pair<size_t, size_t>{div.quot, div.rem};
-            return std::pair<size_t, size_t>{component_index / PageSize, component_index % PageSize};
+            auto [page_index, index_in_page] = this->getIndices(component_index);
+
+            return this->getPageStorage(page_index).at(index_in_page);
         }
 
     }
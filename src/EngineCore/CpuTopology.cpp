@@ -0,0 +1,241 @@
+#include "CpuTopology.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <map>
+#include <set>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <utility>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace
+{
+    using EngineCore::Utility::CpuTopology;
+
+#ifdef __linux__
+    /** Parse a sysfs cpu list like "0-3,8,10-11" */
+    std::vector<int> parseCpuList(std::string const& list)
+    {
+        std::vector<int> retval;
+
+        size_t pos = 0;
+        while (pos < list.size())
+        {
+            size_t end = list.find(',', pos);
+            if (end == std::string::npos) {
+                end = list.size();
+            }
+
+            std::string range = list.substr(pos, end - pos);
+            size_t dash = range.find('-');
+
+            try
+            {
+                if (dash == std::string::npos)
+                {
+                    retval.push_back(std::stoi(range));
+                }
+                else
+                {
+                    int first = std::stoi(range.substr(0, dash));
+                    int last = std::stoi(range.substr(dash + 1));
+                    for (int i = first; i <= last; ++i) {
+                        retval.push_back(i);
+                    }
+                }
+            }
+            catch (std::exception const&)
+            {
+                // ignore malformed entries, e.g. the trailing newline
+            }
+
+            pos = end + 1;
+        }
+
+        return retval;
+    }
+
+    bool readFirstLine(std::string const& path, std::string& line)
+    {
+        std::ifstream file(path);
+        return file.is_open() && static_cast<bool>(std::getline(file, line));
+    }
+
+    int readInt(std::string const& path, int fallback)
+    {
+        std::string line;
+        if (!readFirstLine(path, line)) {
+            return fallback;
+        }
+
+        try {
+            return std::stoi(line);
+        }
+        catch (std::exception const&) {
+            return fallback;
+        }
+    }
+
+    /** Logical cores the calling thread may run on, empty if the affinity mask can't be queried */
+    std::vector<int> getAllowedCpus()
+    {
+        std::vector<int> retval;
+
+        cpu_set_t cpu_set;
+        CPU_ZERO(&cpu_set);
+        if (sched_getaffinity(0, sizeof(cpu_set_t), &cpu_set) != 0) {
+            return retval;
+        }
+
+        for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu)
+        {
+            if (CPU_ISSET(cpu, &cpu_set)) {
+                retval.push_back(cpu);
+            }
+        }
+
+        return retval;
+    }
+
+    bool detectFromSysfs(CpuTopology& topology, std::vector<int> const& allowed_cpu_ids)
+    {
+        std::string online;
+        if (!readFirstLine("/sys/devices/system/cpu/online", online)) {
+            return false;
+        }
+
+        std::vector<int> cpu_ids = parseCpuList(online);
+
+        // drop cores excluded by the affinity mask, e.g. by taskset or a cgroup cpuset
+        if (!allowed_cpu_ids.empty())
+        {
+            cpu_ids.erase(std::remove_if(cpu_ids.begin(), cpu_ids.end(), [&allowed_cpu_ids](int cpu) {
+                return !std::binary_search(allowed_cpu_ids.begin(), allowed_cpu_ids.end(), cpu);
+            }), cpu_ids.end());
+        }
+
+        if (cpu_ids.empty()) {
+            return false;
+        }
+
+        // map logical cores to NUMA nodes, nodes might not be exposed at all on single node machines
+        std::map<int, int> cpu_to_node;
+        std::set<int> nodes;
+        std::string node_online;
+        if (readFirstLine("/sys/devices/system/node/online", node_online))
+        {
+            for (int node : parseCpuList(node_online))
+            {
+                std::string cpu_list;
+                if (readFirstLine("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist", cpu_list))
+                {
+                    for (int cpu : parseCpuList(cpu_list)) {
+                        cpu_to_node[cpu] = node;
+                    }
+                    nodes.insert(node);
+                }
+            }
+        }
+
+        // core ids are only unique within a package, so number physical cores by (package, core id)
+        std::map<std::pair<int, int>, int> physical_core_indices;
+
+        topology.logical_cores.clear();
+        for (int cpu : cpu_ids)
+        {
+            std::string topology_path = "/sys/devices/system/cpu/cpu" + std::to_string(cpu) + "/topology/";
+
+            int package = readInt(topology_path + "physical_package_id", 0);
+            int core_id = readInt(topology_path + "core_id", cpu);
+
+            auto query = physical_core_indices.emplace(std::make_pair(package, core_id), static_cast<int>(physical_core_indices.size()));
+
+            auto node_query = cpu_to_node.find(cpu);
+            int node = (node_query != cpu_to_node.end()) ? node_query->second : 0;
+
+            topology.logical_cores.push_back({ cpu, query.first->second, package, node });
+        }
+
+        // renumber nodes densely, node ids can have gaps
+        std::map<int, int> node_indices;
+        for (auto& core : topology.logical_cores) {
+            node_indices.emplace(core.numa_node, static_cast<int>(node_indices.size()));
+        }
+        for (auto& core : topology.logical_cores) {
+            core.numa_node = node_indices[core.numa_node];
+        }
+        topology.numa_node_cnt = std::max<int>(1, static_cast<int>(node_indices.size()));
+
+        return true;
+    }
+#endif
+}
+
+int EngineCore::Utility::CpuTopology::getPhysicalCoreCount() const
+{
+    std::set<int> physical_cores;
+    for (auto const& core : logical_cores) {
+        physical_cores.insert(core.physical_core);
+    }
+    return static_cast<int>(physical_cores.size());
+}
+
+EngineCore::Utility::CpuTopology EngineCore::Utility::CpuTopology::detect()
+{
+    CpuTopology retval;
+
+    std::vector<int> allowed_cpu_ids;
+
+#ifdef __linux__
+    allowed_cpu_ids = getAllowedCpus();
+
+    if (!detectFromSysfs(retval, allowed_cpu_ids))
+#endif
+    {
+        retval.logical_cores.clear();
+        if (!allowed_cpu_ids.empty())
+        {
+            for (int cpu : allowed_cpu_ids) {
+                retval.logical_cores.push_back({ cpu, cpu, 0, 0 });
+            }
+        }
+        else
+        {
+            int cnt = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+            for (int i = 0; i < cnt; ++i) {
+                retval.logical_cores.push_back({ i, i, 0, 0 });
+            }
+        }
+        retval.numa_node_cnt = 1;
+    }
+
+    std::sort(retval.logical_cores.begin(), retval.logical_cores.end(), [](LogicalCore const& lhs, LogicalCore const& rhs) {
+        return std::tie(lhs.numa_node, lhs.package, lhs.physical_core, lhs.id)
+            < std::tie(rhs.numa_node, rhs.package, rhs.physical_core, rhs.id);
+    });
+
+    return retval;
+}
+
+bool EngineCore::Utility::CpuTopology::pinCurrentThread(int logical_core_id)
+{
+#ifdef __linux__
+    if (logical_core_id < 0 || logical_core_id >= CPU_SETSIZE) {
+        return false;
+    }
+
+    cpu_set_t cpu_set;
+    CPU_ZERO(&cpu_set);
+    CPU_SET(logical_core_id, &cpu_set);
+
+    return pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpu_set) == 0;
+#else
+    return false;
+#endif
+}
@@ -0,0 +1,52 @@
+#ifndef CpuTopology_hpp
+#define CpuTopology_hpp
+
+#include <vector>
+
+namespace EngineCore
+{
+    namespace Utility
+    {
+
+        /**
+         * Hardware thread layout of the machine, i.e. which logical cores share a physical core and
+         * which NUMA node they belong to. Read from sysfs on Linux. On other platforms, or if sysfs is
+         * not available, every logical core is reported as its own physical core on a single node.
+         * On Linux, only cores in the affinity mask of the calling thread are reported, so restrictions by
+         * taskset or a cgroup cpuset are respected.
+         */
+        struct CpuTopology
+        {
+            struct LogicalCore
+            {
+                /** Index as used by the OS for affinity masks */
+                int id;
+                /** Index of the physical core, unique across packages. SMT siblings share the same index. */
+                int physical_core;
+                int package;
+                int numa_node;
+            };
+
+            /** Online logical cores usable by the process, sorted by NUMA node, package, physical core and id */
+            std::vector<LogicalCore> logical_cores;
+
+            int numa_node_cnt = 1;
+
+            int getPhysicalCoreCount() const;
+
+            /**
+             * Detect the topology of the machine the process is running on.
+             */
+            static CpuTopology detect();
+
+            /**
+             * Restrict the calling thread to the given logical core.
+             * \return Returns false if pinning failed or is not supported on this platform.
+             */
+            static bool pinCurrentThread(int logical_core_id);
+        };
+
+    }
+}
+
+#endif // !CpuTopology_hpp
@@ -11,7 +11,7 @@
 
 #include <dxowl/Buffer.hpp>
 #include <dxowl/Mesh.hpp>
-#include "../MTQueue.hpp"
+#include "../MPMCQueue.hpp"
 #include <dxowl/RenderTarget.hpp>
 #include <dxowl/ShaderProgram.hpp>
 #include <dxowl/Texture2D.hpp>
@@ -73,10 +73,14 @@ namespace EngineCore
                 ID3D11DeviceContext4* getD3D11DeviceContext() { return m_d3d11_device_context; }
 
                 void executeRenderThreadTasks() {
-                    while (!m_renderThread_tasks.empty())
+                    m_renderThread_tasks.drain(m_renderThread_batch);
+
+                    for (auto& task : m_renderThread_batch)
                     {
-                        m_renderThread_tasks.pop()();
+                        task();
                     }
+
+                    m_renderThread_batch.clear();
                 }
 
     #pragma region Create mesh
@@ -546,7 +550,8 @@ namespace EngineCore
                 ID3D11Device4* m_d3d11_device;
                 ID3D11DeviceContext4* m_d3d11_device_context;
 
-                EngineCore::Utility::MTQueue<std::function<void()>> m_renderThread_tasks;
+                EngineCore::Utility::MPMCQueue<std::function<void()>> m_renderThread_tasks;
+                std::vector<std::function<void()>> m_renderThread_batch;
 
                 std::vector<Resource<dxowl::RenderTarget>> m_render_targets;
                 std::unordered_map<unsigned int, size_t>   m_id_to_renderTarget_idx;
@@ -128,15 +128,15 @@ void EngineCore::Graphics::Dx11::setupSimpleForwardRenderingPipeline(
             data.view_proj_buffer.view_projection = glm::transpose(cam_mngr.getProjectionMatrix(camera_idx) * glm::inverse(transform_mngr.getWorldTransformation(camera_transform_idx)));
         }
 
-        auto static_mesh_rts = staticMesh_renderTask_mngr.getComponentDataCopy();
+        auto static_mesh_rts = staticMesh_renderTask_mngr.getComponentDataSnapshot();
 
-        data.static_mesh_constant_buffers.reserve(static_mesh_rts.size());
-        data.static_mesh_render_task_data.reserve(static_mesh_rts.size());
+        data.static_mesh_constant_buffers.reserve(static_mesh_rts->size());
+        data.static_mesh_render_task_data.reserve(static_mesh_rts->size());
 
         data.opaque_objs_cnt = 0;
         data.transparent_objs_cnt = 0;
 
-        for (auto const& rt : static_mesh_rts)
+        for (auto const& rt : *static_mesh_rts)
         {
             data.static_mesh_constant_buffers.push_back(GeomPassData::StaticMeshConstantBuffer());
 
@@ -188,12 +188,12 @@ void EngineCore::Graphics::Dx11::setupSimpleForwardRenderingPipeline(
         }
 
         // gather data for unlit objects
-        auto unlit_rts = unlit_renderTask_mngr.getComponentDataCopy();
+        auto unlit_rts = unlit_renderTask_mngr.getComponentDataSnapshot();
         
-        data.unlit_constant_buffer.reserve(unlit_rts.size());
-        data.unlit_render_task_data.reserve(unlit_rts.size());
+        data.unlit_constant_buffer.reserve(unlit_rts->size());
+        data.unlit_render_task_data.reserve(unlit_rts->size());
         
-        for (auto const& rt : unlit_rts)
+        for (auto const& rt : *unlit_rts)
         {
             data.unlit_constant_buffer.push_back(GeomPassData::UnlitMeshConstantBuffer());
 
@@ -728,4 +728,6 @@ void EngineCore::Graphics::Dx11::setupSimpleForwardRenderingPipeline(
         );
     }
     );
+
+    frame.setupRenderPassData();
 }
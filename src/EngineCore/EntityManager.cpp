@@ -1,70 +1,276 @@
 #include "EntityManager.hpp"
 
-#include <shared_mutex>
+#include <algorithm>
+
+EntityManager::Page::Page()
+{
+    for (auto& generation : generations) {
+        generation.store(0, std::memory_order_relaxed);
+    }
+    for (auto& word : alive_bits) {
+        word.store(0, std::memory_order_relaxed);
+    }
+}
+
+EntityManager::EntityManager()
+    : m_pages(new std::atomic<Page*>[page_cnt]), m_next_index(0), m_free_index_cnt(0)
+{
+    for (size_t page_idx = 0; page_idx < page_cnt; ++page_idx) {
+        m_pages[page_idx].store(nullptr, std::memory_order_relaxed);
+    }
+}
+
+EntityManager::~EntityManager()
+{
+    for (size_t page_idx = 0; page_idx < page_cnt; ++page_idx) {
+        delete m_pages[page_idx].load(std::memory_order_relaxed);
+    }
+}
+
+EntityManager::Page& EntityManager::getPage(size_t index)
+{
+    auto& page_ptr = m_pages[index >> page_bits];
+
+    Page* page = page_ptr.load(std::memory_order_acquire);
+
+    if (page == nullptr)
+    {
+        // several threads might create the first entity of a page at the same time, only one page is kept
+        Page* new_page = new Page();
+
+        if (page_ptr.compare_exchange_strong(page, new_page, std::memory_order_acq_rel, std::memory_order_acquire)) {
+            page = new_page;
+        }
+        else {
+            delete new_page;
+        }
+    }
+
+    return *page;
+}
+
+void EntityManager::popFreeIndices(size_t cnt, std::vector<uint>& indices)
+{
+    // cheap check first, to keep the common case of fresh indices lock-free
+    if (m_free_index_cnt.load(std::memory_order_relaxed) <= free_index_threshold) {
+        return;
+    }
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    while (cnt > 0 && m_free_indices.size() > free_index_threshold)
+    {
+        indices.push_back(m_free_indices.front());
+        m_free_indices.pop_front();
+        --cnt;
+    }
+
+    m_free_index_cnt.store(m_free_indices.size(), std::memory_order_relaxed);
+}
+
+Entity EntityManager::activate(uint index)
+{
+    Page& page = getPage(index);
+    size_t index_in_page = index & (page_size - 1);
+
+    Entity entity;
+    entity.m_id = index | (static_cast<uint>(page.generations[index_in_page].load(std::memory_order_relaxed)) << ENTITY_INDEX_BITS);
+
+    page.alive_bits[index_in_page / 64].fetch_or(uint64_t(1) << (index_in_page % 64), std::memory_order_release);
+
+    return entity;
+}
+
+bool EntityManager::deactivate(Entity entity)
+{
+    if (!alive(entity)) {
+        return false;
+    }
+
+    size_t index = entity.index();
+    Page& page = *m_pages[index >> page_bits].load(std::memory_order_acquire);
+    size_t index_in_page = index & (page_size - 1);
+
+    uint64_t bit = uint64_t(1) << (index_in_page % 64);
+
+    // only one of several concurrent destroys of the same entity gets to release the index
+    if ((page.alive_bits[index_in_page / 64].fetch_and(~bit, std::memory_order_acq_rel) & bit) == 0) {
+        return false;
+    }
+
+    // the generation wraps around, the free index threshold makes that rare
+    page.generations[index_in_page].store(static_cast<uint8_t>(entity.generation() + 1), std::memory_order_relaxed);
+
+    return true;
+}
 
 Entity EntityManager::create()
 {
-    std::unique_lock<std::shared_mutex> lock(m_mutex);
+    std::vector<uint> reused_index;
+    popFreeIndices(1, reused_index);
 
-    Entity new_entity;
+    if (!reused_index.empty()) {
+        return activate(reused_index.front());
+    }
+
+    size_t index = m_next_index.fetch_add(1, std::memory_order_relaxed);
 
-    if ((m_is_alive.size()) < MAX_ENTITY_ID)
+    if (index > MAX_ENTITY_ID)
     {
-        m_is_alive.push_back(true);
-        new_entity.m_id = static_cast<uint>(m_is_alive.size()) - 1;
+        //Duh!
+        m_next_index.fetch_sub(1, std::memory_order_relaxed);
+        return invalidEntity();
     }
-    else
+
+    return activate(static_cast<uint>(index));
+}
+
+std::vector<Entity> EntityManager::create(size_t cnt)
+{
+    std::vector<Entity> retval;
+    retval.reserve(cnt);
+
+    std::vector<uint> reused_indices;
+    popFreeIndices(cnt, reused_indices);
+
+    for (auto index : reused_indices) {
+        retval.push_back(activate(index));
+    }
+
+    // take the remaining indices as one contiguous block of fresh indices
+    size_t fresh_cnt = cnt - reused_indices.size();
+    size_t first_index = m_next_index.fetch_add(fresh_cnt, std::memory_order_relaxed);
+
+    if (first_index + fresh_cnt > MAX_ENTITY_ID + 1)
     {
-        if (!m_free_indices.empty())
-        {
-            new_entity.m_id = m_free_indices.front();
-            m_free_indices.pop_front();
-            m_is_alive[new_entity.m_id] = true;
-        }
-        else
+        //Duh! Hand back the part of the block beyond the last valid index, the caller sees the shortfall in the result size
+        size_t granted_cnt = (first_index <= MAX_ENTITY_ID) ? MAX_ENTITY_ID + 1 - first_index : 0;
+        m_next_index.fetch_sub(fresh_cnt - granted_cnt, std::memory_order_relaxed);
+        fresh_cnt = granted_cnt;
+    }
+
+    size_t index = first_index;
+    size_t end_index = first_index + fresh_cnt;
+
+    while (index < end_index)
+    {
+        Page& page = getPage(index);
+        size_t index_in_page = index & (page_size - 1);
+        size_t word_idx = index_in_page / 64;
+
+        // set the alive bits word by word, fresh indices all have generation 0
+        size_t bit_begin = index_in_page % 64;
+        size_t bit_end = std::min<size_t>(64, bit_begin + (end_index - index));
+        uint64_t mask = (bit_end - bit_begin == 64) ? ~uint64_t(0) : (((uint64_t(1) << (bit_end - bit_begin)) - 1) << bit_begin);
+
+        for (size_t bit = bit_begin; bit < bit_end; ++bit)
         {
-            //Duh!
+            Entity entity;
+            entity.m_id = static_cast<uint>(index + (bit - bit_begin));
+            retval.push_back(entity);
         }
+
+        page.alive_bits[word_idx].fetch_or(mask, std::memory_order_release);
+
+        index += bit_end - bit_begin;
     }
 
-    return new_entity;
+    return retval;
 }
 
 void EntityManager::destroy(Entity entity)
 {
-    std::unique_lock<std::shared_mutex> lock(m_mutex);
+    // entities that are already dead, e.g. destroyed twice, are not recorded again
+    if (!deactivate(entity)) {
+        return;
+    }
 
-    m_is_alive[entity.m_id] = false;
-    m_free_indices.push_back(entity.m_id);
+    std::unique_lock<std::mutex> lock(m_destroyed_entities_mutex);
 
-    // TODO //
-    // maybe send out a couple of message to component managers etc.
-    // that want to immediatly get rid of components (looking at you renderer)
+    m_destroyed_entities.push_back(entity);
+}
+
+void EntityManager::destroy(std::span<Entity const> entities)
+{
+    std::vector<Entity> destroyed_entities;
+    destroyed_entities.reserve(entities.size());
+
+    for (auto entity : entities)
+    {
+        if (deactivate(entity)) {
+            destroyed_entities.push_back(entity);
+        }
+    }
+
+    std::unique_lock<std::mutex> lock(m_destroyed_entities_mutex);
+
+    m_destroyed_entities.insert(m_destroyed_entities.end(), destroyed_entities.begin(), destroyed_entities.end());
+}
+
+std::vector<Entity> EntityManager::takeDestroyedEntities()
+{
+    std::vector<Entity> retval;
+
+    std::unique_lock<std::mutex> lock(m_destroyed_entities_mutex);
+    retval.swap(m_destroyed_entities);
+
+    return retval;
+}
+
+void EntityManager::release(std::span<Entity const> entities)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    for (auto entity : entities) {
+        m_free_indices.push_back(entity.index());
+    }
+    m_free_index_cnt.store(m_free_indices.size(), std::memory_order_relaxed);
 }
 
 size_t EntityManager::getEntityCount() const
 {
-    std::shared_lock<std::shared_mutex> lock(m_mutex);
-    return m_is_alive.size();
+    return std::min<size_t>(m_next_index.load(std::memory_order_relaxed), MAX_ENTITY_ID + 1);
 }
 
 std::pair<bool, Entity> EntityManager::getEntity(uint index) const
 {
     std::pair<bool, Entity> rtn(false, invalidEntity());
 
-    rtn.first = (m_is_alive.size() > index) ? true : false;
+    if (index > MAX_ENTITY_ID) {
+        return rtn;
+    }
 
-    if (rtn.first)
-    {
-        rtn.second.m_id = index;
+    Page const* page = m_pages[index >> page_bits].load(std::memory_order_acquire);
 
-        rtn.first = m_is_alive[index];
+    if (page == nullptr) {
+        return rtn;
     }
 
+    size_t index_in_page = index & (page_size - 1);
+
+    rtn.first = (page->alive_bits[index_in_page / 64].load(std::memory_order_acquire) >> (index_in_page % 64)) & 1;
+    rtn.second.m_id = index | (static_cast<uint>(page->generations[index_in_page].load(std::memory_order_relaxed)) << ENTITY_INDEX_BITS);
+
     return rtn;
 }
 
 bool EntityManager::alive(Entity entity) const
 {
-    return m_is_alive[entity.m_id];
-}
\ No newline at end of file
+    size_t index = entity.index();
+
+    if (index > MAX_ENTITY_ID) {
+        return false;
+    }
+
+    Page const* page = m_pages[index >> page_bits].load(std::memory_order_acquire);
+
+    if (page == nullptr) {
+        return false;
+    }
+
+    size_t index_in_page = index & (page_size - 1);
+
+    bool is_alive = (page->alive_bits[index_in_page / 64].load(std::memory_order_acquire) >> (index_in_page % 64)) & 1;
+
+    return is_alive && page->generations[index_in_page].load(std::memory_order_relaxed) == entity.generation();
+}
@@ -1,17 +1,32 @@
 #ifndef EntityManager_h
 #define EntityManager_h
 
+#include <atomic>
+#include <cstdint>
 #include <deque>
 #include <limits>
-#include <shared_mutex>
+#include <memory>
+#include <mutex>
+#include <span>
 #include <vector>
 
 #include "types.hpp"
 
-const size_t MAX_ENTITY_ID = std::numeric_limits<uint>::max() - 1;
+/** Number of bits of an entity id used for the index, the remaining bits hold the generation */
+const uint ENTITY_INDEX_BITS = 24;
+
+/** Highest index of a valid entity, the all-ones index is reserved for the invalid entity */
+const size_t MAX_ENTITY_ID = (size_t(1) << ENTITY_INDEX_BITS) - 2;
+
+namespace EngineCore {
+    template <typename... ComponentManagerTypes>
+    class Query;
+}
 
 /**
  * Most basic entity representation using only a unique id.
+ * The id packs an index (lower 24 bits) and a generation (upper 8 bits). Indices are reused
+ * after an entity is destroyed, the generation tells apart entities that share an index.
  * The id of an entity can't be changed after construction
  * and only the EntityManager is allowed to construct new enties.
  */
@@ -22,42 +37,136 @@ public:
 
     inline uint id() const { return m_id; }
 
+    inline uint index() const { return m_id & ((1u << ENTITY_INDEX_BITS) - 1); }
+
+    inline uint generation() const { return m_id >> ENTITY_INDEX_BITS; }
+
     inline bool operator==(const Entity& rhs) { return m_id == rhs.id(); }
     inline bool operator!=(const Entity& rhs) { return m_id != rhs.id(); }
 
     friend class EntityManager;
+
+    template <typename... ComponentManagerTypes>
+    friend class EngineCore::Query;
 private:
     uint m_id;
 };
 
 class EntityManager
 {
+    static constexpr size_t page_bits = 12;
+    static constexpr size_t page_size = size_t(1) << page_bits;
+    static constexpr size_t page_cnt = size_t(1) << (ENTITY_INDEX_BITS - page_bits);
+
+    /**
+     * Destroyed indices are only reused once more than this many are waiting, so that an index
+     * is not reused (and its generation incremented) too often, which would make stale entities
+     * of a wrapped-around generation alive again.
+     */
+    static constexpr size_t free_index_threshold = 1024;
+
+    struct Page
+    {
+        Page();
+
+        std::atomic<uint8_t>  generations[page_size];
+        /** One bit per index, set while the entity is alive */
+        std::atomic<uint64_t> alive_bits[page_size / 64];
+    };
+
     /**
-     * Keeps track of created entities.
+     * Pages of entity state by index range, allocated on first use and never freed before destruction,
+     * so that alive checks can run without locking.
      */
-    std::vector<bool> m_is_alive;
+    std::unique_ptr<std::atomic<Page*>[]> m_pages;
+
+    /** Next never used index */
+    std::atomic<size_t> m_next_index;
 
     /**
-     * Store ids (indices) of deleted entities in order to reuse
-     * reuse them once the number of created entities exceeds
-     * the value range of a uint.
+     * Store ids (indices) of deleted entities in order to reuse them.
      * Ids are reused in order of deletion, i.e. the time between
      * deletion and reuse is maximized.
      */
     std::deque<uint> m_free_indices;
 
+    /** Size of m_free_indices, readable without locking */
+    std::atomic<size_t> m_free_index_cnt;
+
     /** Mutex to protect queue operations. */
-    mutable std::shared_mutex m_mutex;
+    mutable std::mutex m_mutex;
+
+    /** Entities destroyed since the last call of takeDestroyedEntities, each only once */
+    std::vector<Entity> m_destroyed_entities;
+
+    std::mutex m_destroyed_entities_mutex;
+
+    Page& getPage(size_t index);
+
+    /** Take up to cnt reusable indices from the free list */
+    void popFreeIndices(size_t cnt, std::vector<uint>& indices);
+
+    /** Mark the entity at the index alive and return it with the index's current generation */
+    Entity activate(uint index);
+
+    /** Clear the alive bit and advance the generation. Returns false if the entity is not alive. */
+    bool deactivate(Entity entity);
 
 public:
+    EntityManager();
+    ~EntityManager();
+
+    EntityManager(EntityManager const& cpy) = delete;
+    EntityManager& operator=(EntityManager const& rhs) = delete;
+
+    /**
+     * Create a new entity. Lock-free unless destroyed indices are reused.
+     */
     Entity create();
 
+    /**
+     * Create cnt entities at once, e.g. for spawning prefabs. Takes the lock at most once.
+     * \return Returns the created entities, fewer than cnt if all entity ids are in use.
+     */
+    std::vector<Entity> create(size_t cnt);
+
+    /**
+     * Destroy the entity, it is no longer alive after the call. Removing its components is deferred
+     * to the next frame boundary (see WorldState::processDestroyedEntities), its index is not reused before.
+     */
     void destroy(Entity entity);
 
+    /**
+     * Destroy several entities at once. Takes the lock once.
+     */
+    void destroy(std::span<Entity const> entities);
+
+    /**
+     * Take the entities destroyed since the last call. Each destroyed entity is taken once.
+     */
+    std::vector<Entity> takeDestroyedEntities();
+
+    /**
+     * Finish destruction of the given entities after their components were removed,
+     * i.e. let their indices be reused. Takes the lock once.
+     */
+    void release(std::span<Entity const> entities);
+
+    /**
+     * Number of indices handed out so far, i.e. valid indices for getEntity are in [0, getEntityCount()).
+     */
     size_t getEntityCount() const;
 
+    /**
+     * Get the entity currently using the given index.
+     * \return Returns false and the entity of the index's current generation if the index is not in use.
+     */
     std::pair<bool, Entity> getEntity(uint index) const;
 
+    /**
+     * Check if the entity is alive, i.e. was created and not destroyed yet.
+     * Entities whose index was reused for a newer entity are not alive.
+     */
     bool alive(Entity entity) const;
 
     /**
@@ -67,4 +176,4 @@ public:
     static Entity invalidEntity() { return Entity(); }
 };
 
-#endif
\ No newline at end of file
+#endif
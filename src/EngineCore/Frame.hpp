@@ -1,11 +1,16 @@
 #ifndef Frame_hpp
 #define Frame_hpp
 
+#include <algorithm>
+#include <atomic>
+#include <iostream>
+#include <memory>
 #include <mutex>
 #include <vector>
 
 #include "types.hpp"
 #include "RenderPass.hpp"
+#include "TaskScheduler.hpp"
 
 namespace EngineCore
 {
@@ -27,17 +32,115 @@ namespace EngineCore
             // render passes
             std::vector<Graphics::RenderPass> m_render_passes;
 
+            /** Per render pass, indices of earlier passes whose data setup has to finish before its own starts */
+            std::vector<std::vector<size_t>> m_render_pass_setup_dependencies;
+
+            /** Number of render passes (from the front) whose data setup has already been executed */
+            size_t m_render_pass_setup_cnt = 0;
+
+            /**
+             * Add a render pass to the frame. The data setup is not executed right away but with
+             * the next call of setupRenderPassData, together with all other passes added in the meantime.
+             * \param setup_dependencies Descriptions of earlier added passes whose data setup has to be
+             * finished before this pass's data setup may start, e.g. because they modify shared state.
+             * Names that match no earlier pass are reported and ignored.
+             */
             template<typename T1, typename T2>
             void addRenderPass(
                 std::string const& pass_description,
                 std::function<void(T1&, T2&)> setup_callback,
                 std::function<void(T1&, T2&)> compile_callback,
-                std::function<void(T1 const&, T2 const&)> execute_callback)
+                std::function<void(T1 const&, T2 const&)> execute_callback,
+                std::vector<std::string> const& setup_dependencies = {})
             {
+                std::vector<size_t> dependencies;
+                for (auto const& dependency : setup_dependencies)
+                {
+                    size_t resolved_cnt = 0;
+                    for (size_t i = 0; i < m_render_passes.size(); ++i)
+                    {
+                        if (m_render_passes[i].getDescription() == dependency) {
+                            dependencies.push_back(i);
+                            ++resolved_cnt;
+                        }
+                    }
+
+                    if (resolved_cnt == 0) {
+                        std::cerr << "Render pass " << pass_description << " depends on unknown render pass " << dependency << std::endl;
+                    }
+                }
+
                 m_render_passes.push_back(
                     Graphics::RenderPass(pass_description, setup_callback, compile_callback, execute_callback)
                 );
-                m_render_passes.back().setupData();
+                m_render_pass_setup_dependencies.push_back(std::move(dependencies));
+            }
+
+            /**
+             * Execute the data setup of all passes added since the last call, in order of addition.
+             */
+            void setupRenderPassData()
+            {
+                for (size_t i = m_render_pass_setup_cnt; i < m_render_passes.size(); ++i) {
+                    m_render_passes[i].setupData();
+                }
+                m_render_pass_setup_cnt = m_render_passes.size();
+            }
+
+            /**
+             * Execute the data setup of all passes added since the last call concurrently on the task scheduler,
+             * respecting the declared setup dependencies. Blocks until all data setups are finished.
+             */
+            void setupRenderPassData(Utility::TaskScheduler& task_scheduler)
+            {
+                size_t first_pass_idx = m_render_pass_setup_cnt;
+                size_t pass_cnt = m_render_passes.size() - first_pass_idx;
+
+                // dependencies on passes that are already set up are fulfilled
+                std::vector<std::vector<size_t>> successors(pass_cnt);
+                std::unique_ptr<std::atomic_size_t[]> remaining_predecessors(new std::atomic_size_t[pass_cnt]);
+
+                for (size_t i = 0; i < pass_cnt; ++i)
+                {
+                    size_t predecessor_cnt = 0;
+                    for (auto dependency : m_render_pass_setup_dependencies[first_pass_idx + i])
+                    {
+                        if (dependency >= first_pass_idx)
+                        {
+                            successors[dependency - first_pass_idx].push_back(i);
+                            ++predecessor_cnt;
+                        }
+                    }
+                    remaining_predecessors[i] = predecessor_cnt;
+                }
+
+                Utility::TaskGroup task_group;
+
+                // every finished setup submits those of its successors that have no more unfinished predecessors
+                std::function<void(size_t)> setup_pass = [&](size_t pass_idx)
+                {
+                    m_render_passes[first_pass_idx + pass_idx].setupData();
+
+                    for (auto successor_idx : successors[pass_idx])
+                    {
+                        if (--remaining_predecessors[successor_idx] == 0) {
+                            task_scheduler.submitTask([&setup_pass, successor_idx]() { setup_pass(successor_idx); }, task_group);
+                        }
+                    }
+                };
+
+                std::vector<Utility::Task> initial_tasks;
+                for (size_t i = 0; i < pass_cnt; ++i)
+                {
+                    if (remaining_predecessors[i] == 0) {
+                        initial_tasks.push_back([&setup_pass, i]() { setup_pass(i); });
+                    }
+                }
+
+                task_scheduler.submitTasks(std::move(initial_tasks), task_group);
+                task_scheduler.wait(task_group);
+
+                m_render_pass_setup_cnt = m_render_passes.size();
             }
         };
 
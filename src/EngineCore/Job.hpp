@@ -0,0 +1,441 @@
+#ifndef Job_hpp
+#define Job_hpp
+
+#include <atomic>
+#include <condition_variable>
+#include <coroutine>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "RenderThreadScheduler.hpp"
+#include "TaskScheduler.hpp"
+
+namespace EngineCore
+{
+    namespace Utility
+    {
+
+        template<typename T>
+        class Job;
+
+        namespace detail
+        {
+            struct JobPromiseBase
+            {
+                /** Final awaiter that continues with the awaiting coroutine, if any, without growing the stack */
+                struct FinalAwaiter
+                {
+                    bool await_ready() const noexcept { return false; }
+
+                    template<typename Promise>
+                    std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> handle) noexcept
+                    {
+                        std::coroutine_handle<> continuation = handle.promise().continuation;
+                        return continuation ? continuation : std::noop_coroutine();
+                    }
+
+                    void await_resume() const noexcept {}
+                };
+
+                /** Jobs are lazy, they only start when awaited */
+                std::suspend_always initial_suspend() const noexcept { return {}; }
+
+                FinalAwaiter final_suspend() const noexcept { return {}; }
+
+                void unhandled_exception() { exception = std::current_exception(); }
+
+                std::coroutine_handle<> continuation;
+                std::exception_ptr      exception;
+            };
+
+            template<typename T>
+            struct JobPromise : JobPromiseBase
+            {
+                Job<T> get_return_object();
+
+                template<typename U>
+                void return_value(U&& value) { result.emplace(std::forward<U>(value)); }
+
+                T getResult()
+                {
+                    if (exception) {
+                        std::rethrow_exception(exception);
+                    }
+                    return std::move(*result);
+                }
+
+                std::optional<T> result;
+            };
+
+            template<>
+            struct JobPromise<void> : JobPromiseBase
+            {
+                Job<void> get_return_object();
+
+                void return_void() const noexcept {}
+
+                void getResult()
+                {
+                    if (exception) {
+                        std::rethrow_exception(exception);
+                    }
+                }
+            };
+        }
+
+        /**
+         * Coroutine for multi-stage asynchronous work, e.g. asset import pipelines.
+         * A job is lazy, it starts executing on the thread that awaits it (co_await) and switches
+         * threads by awaiting resumeOn(...). While suspended, a job does not occupy a worker thread.
+         * Exceptions thrown by the job are rethrown to the awaiting coroutine.
+         */
+        template<typename T = void>
+        class Job
+        {
+        public:
+            typedef detail::JobPromise<T> promise_type;
+
+            Job() = default;
+            explicit Job(std::coroutine_handle<promise_type> handle) : handle_(handle) {}
+            ~Job() { if (handle_) handle_.destroy(); }
+
+            Job(Job&& other) noexcept : handle_(std::exchange(other.handle_, nullptr)) {}
+
+            Job& operator=(Job&& rhs) noexcept
+            {
+                if (this != &rhs)
+                {
+                    if (handle_) handle_.destroy();
+                    handle_ = std::exchange(rhs.handle_, nullptr);
+                }
+                return *this;
+            }
+
+            Job(Job const& cpy) = delete;
+            Job& operator=(Job const& rhs) = delete;
+
+            bool done() const { return !handle_ || handle_.done(); }
+
+            /** Start the job (if not done yet) and suspend the awaiting coroutine until it is finished */
+            auto operator co_await() && noexcept
+            {
+                struct Awaiter
+                {
+                    std::coroutine_handle<promise_type> handle;
+
+                    bool await_ready() const noexcept { return !handle || handle.done(); }
+
+                    std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept
+                    {
+                        handle.promise().continuation = awaiting;
+                        return handle;
+                    }
+
+                    T await_resume() { return handle.promise().getResult(); }
+                };
+
+                return Awaiter{ handle_ };
+            }
+
+        private:
+            std::coroutine_handle<promise_type> handle_;
+        };
+
+        template<typename T>
+        inline Job<T> detail::JobPromise<T>::get_return_object()
+        {
+            return Job<T>(std::coroutine_handle<JobPromise<T>>::from_promise(*this));
+        }
+
+        inline Job<void> detail::JobPromise<void>::get_return_object()
+        {
+            return Job<void>(std::coroutine_handle<JobPromise<void>>::from_promise(*this));
+        }
+
+        /**
+         * Awaitable that continues the awaiting coroutine on a worker thread of the given scheduler.
+         */
+        inline auto resumeOn(TaskScheduler& scheduler)
+        {
+            struct Awaiter
+            {
+                TaskScheduler& scheduler;
+
+                bool await_ready() const noexcept { return false; }
+
+                void await_suspend(std::coroutine_handle<> handle) { scheduler.submitTask([handle]() { handle.resume(); }); }
+
+                void await_resume() const noexcept {}
+            };
+
+            return Awaiter{ scheduler };
+        }
+
+        /**
+         * Awaitable that continues the awaiting coroutine on the render thread, i.e. as a task
+         * of the given render thread scheduler, e.g. for GPU uploads at the end of an import pipeline.
+         */
+        inline auto resumeOn(RenderThreadScheduler& render_thread_scheduler,
+            RenderThreadScheduler::Priority priority = RenderThreadScheduler::Priority::STREAMING)
+        {
+            struct Awaiter
+            {
+                RenderThreadScheduler&          scheduler;
+                RenderThreadScheduler::Priority priority;
+
+                bool await_ready() const noexcept { return false; }
+
+                void await_suspend(std::coroutine_handle<> handle) { scheduler.submit([handle]() { handle.resume(); }, priority); }
+
+                void await_resume() const noexcept {}
+            };
+
+            return Awaiter{ render_thread_scheduler, priority };
+        }
+
+        namespace detail
+        {
+            /**
+             * Completion counter shared by a set of jobs started together.
+             * The last job to finish either resumes the continuation or, if there is none, signals blocking waiters.
+             */
+            struct JobCounter
+            {
+                explicit JobCounter(size_t cnt) : remaining(cnt) {}
+
+                std::atomic<size_t>     remaining;
+                std::coroutine_handle<> continuation;
+
+                std::mutex              mutex;
+                std::condition_variable cvar;
+                bool                    done = false;
+            };
+
+            /**
+             * Eagerly awaits a single job on behalf of whenAll and syncWait, reporting completion to a JobCounter.
+             */
+            class CountedJob
+            {
+            public:
+                struct promise_type
+                {
+                    struct FinalAwaiter
+                    {
+                        bool await_ready() const noexcept { return false; }
+
+                        std::coroutine_handle<> await_suspend(std::coroutine_handle<promise_type> handle) noexcept
+                        {
+                            JobCounter* counter = handle.promise().counter;
+
+                            if (counter->remaining.fetch_sub(1, std::memory_order_acq_rel) != 1) {
+                                return std::noop_coroutine();
+                            }
+
+                            if (counter->continuation) {
+                                return counter->continuation;
+                            }
+
+                            std::lock_guard<std::mutex> lock(counter->mutex);
+                            counter->done = true;
+                            counter->cvar.notify_all();
+
+                            return std::noop_coroutine();
+                        }
+
+                        void await_resume() const noexcept {}
+                    };
+
+                    CountedJob get_return_object() { return CountedJob(std::coroutine_handle<promise_type>::from_promise(*this)); }
+
+                    std::suspend_always initial_suspend() const noexcept { return {}; }
+
+                    FinalAwaiter final_suspend() const noexcept { return {}; }
+
+                    void return_void() const noexcept {}
+
+                    void unhandled_exception() { exception = std::current_exception(); }
+
+                    JobCounter*        counter = nullptr;
+                    std::exception_ptr exception;
+                };
+
+                explicit CountedJob(std::coroutine_handle<promise_type> handle) : handle_(handle) {}
+                ~CountedJob() { if (handle_) handle_.destroy(); }
+
+                CountedJob(CountedJob&& other) noexcept : handle_(std::exchange(other.handle_, nullptr)) {}
+                CountedJob(CountedJob const& cpy) = delete;
+                CountedJob& operator=(CountedJob const& rhs) = delete;
+                CountedJob& operator=(CountedJob&& rhs) = delete;
+
+                void setCounter(JobCounter& counter) { handle_.promise().counter = &counter; }
+
+                std::coroutine_handle<> getHandle() const { return handle_; }
+
+                void rethrowIfFailed() const
+                {
+                    if (handle_.promise().exception) {
+                        std::rethrow_exception(handle_.promise().exception);
+                    }
+                }
+
+            private:
+                std::coroutine_handle<promise_type> handle_;
+            };
+
+            template<typename T>
+            inline CountedJob awaitCounted(Job<T> job, std::optional<T>& result)
+            {
+                result.emplace(co_await std::move(job));
+            }
+
+            inline CountedJob awaitCounted(Job<void> job)
+            {
+                co_await std::move(job);
+            }
+
+            /** Start all counted jobs on the scheduler and resume the awaiting coroutine once all of them finished */
+            struct WhenAllAwaiter
+            {
+                TaskScheduler&           scheduler;
+                std::vector<CountedJob>& jobs;
+                JobCounter&              counter;
+
+                bool await_ready() const noexcept { return jobs.empty(); }
+
+                bool await_suspend(std::coroutine_handle<> handle)
+                {
+                    counter.continuation = handle;
+
+                    for (auto& job : jobs)
+                    {
+                        job.setCounter(counter);
+                        scheduler.submitTask([job_handle = job.getHandle()]() { job_handle.resume(); });
+                    }
+
+                    // the extra count keeps the jobs from resuming us before all of them have been submitted
+                    return counter.remaining.fetch_sub(1, std::memory_order_acq_rel) != 1;
+                }
+
+                void await_resume() const
+                {
+                    for (auto& job : jobs) {
+                        job.rethrowIfFailed();
+                    }
+                }
+            };
+
+            inline void syncWait(CountedJob counted_job)
+            {
+                JobCounter counter(1);
+                counted_job.setCounter(counter);
+                counted_job.getHandle().resume();
+
+                {
+                    std::unique_lock<std::mutex> lock(counter.mutex);
+                    counter.cvar.wait(lock, [&counter]() { return counter.done; });
+                }
+
+                counted_job.rethrowIfFailed();
+            }
+        }
+
+        /**
+         * Run all given jobs concurrently on worker threads of the scheduler and finish once all of them finished.
+         * \return Returns the results in the order of the given jobs
+         */
+        template<typename T>
+        inline Job<std::vector<T>> whenAll(TaskScheduler& scheduler, std::vector<Job<T>> jobs)
+        {
+            std::vector<std::optional<T>> results(jobs.size());
+            std::vector<detail::CountedJob> counted_jobs;
+            counted_jobs.reserve(jobs.size());
+
+            for (size_t i = 0; i < jobs.size(); ++i) {
+                counted_jobs.push_back(detail::awaitCounted(std::move(jobs[i]), results[i]));
+            }
+
+            detail::JobCounter counter(counted_jobs.size() + 1);
+            co_await detail::WhenAllAwaiter{ scheduler, counted_jobs, counter };
+
+            std::vector<T> retval;
+            retval.reserve(results.size());
+            for (auto& result : results) {
+                retval.push_back(std::move(*result));
+            }
+
+            co_return retval;
+        }
+
+        inline Job<void> whenAll(TaskScheduler& scheduler, std::vector<Job<void>> jobs)
+        {
+            std::vector<detail::CountedJob> counted_jobs;
+            counted_jobs.reserve(jobs.size());
+
+            for (auto& job : jobs) {
+                counted_jobs.push_back(detail::awaitCounted(std::move(job)));
+            }
+
+            detail::JobCounter counter(counted_jobs.size() + 1);
+            co_await detail::WhenAllAwaiter{ scheduler, counted_jobs, counter };
+        }
+
+        /**
+         * Start the job on the calling thread and block until it is finished.
+         * Meant for threads outside of the worker pool, blocking a worker thread can deadlock the scheduler.
+         */
+        template<typename T>
+        inline T syncWait(Job<T> job)
+        {
+            std::optional<T> result;
+            detail::syncWait(detail::awaitCounted(std::move(job), result));
+            return std::move(*result);
+        }
+
+        inline void syncWait(Job<void> job)
+        {
+            detail::syncWait(detail::awaitCounted(std::move(job)));
+        }
+
+        namespace detail
+        {
+            /** Self-destroying coroutine for fire-and-forget jobs */
+            struct DetachedJob
+            {
+                struct promise_type
+                {
+                    DetachedJob get_return_object() const noexcept { return {}; }
+
+                    std::suspend_never initial_suspend() const noexcept { return {}; }
+
+                    std::suspend_never final_suspend() const noexcept { return {}; }
+
+                    void return_void() const noexcept {}
+
+                    void unhandled_exception() const noexcept { std::terminate(); }
+                };
+            };
+
+            inline DetachedJob runDetached(TaskScheduler& scheduler, Job<void> job)
+            {
+                co_await resumeOn(scheduler);
+                co_await std::move(job);
+            }
+        }
+
+        /**
+         * Start the job on a worker thread of the scheduler without waiting for it.
+         * The job has to handle its exceptions itself, an escaping exception terminates the program.
+         */
+        inline void startDetached(TaskScheduler& scheduler, Job<void> job)
+        {
+            detail::runDetached(scheduler, std::move(job));
+        }
+
+    }
+}
+
+#endif // !Job_hpp
@@ -116,6 +116,8 @@ namespace EngineCore {
 
                 void deleteComponent(uint idx);
 
+                void deleteComponents(std::span<Entity const> entities) override;
+
                 std::pair<bool, uint> getIndex(Entity entity) const;
 
                 /** Set the ribbon width of a single Feature Curve to a new value */
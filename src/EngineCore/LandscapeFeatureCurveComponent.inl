@@ -273,6 +273,54 @@ void EngineCore::Graphics::Landscape::FeatureCurveComponentManager<ResourceManag
 
 }
 
+template<typename ResourceManagerType>
+void EngineCore::Graphics::Landscape::FeatureCurveComponentManager<ResourceManagerType>::deleteComponents(std::span<Entity const> entities)
+{
+    std::unique_lock<std::shared_mutex> lock(m_dataAccess_mutex);
+
+    bool any_removed = false;
+
+    for (auto entity : entities)
+    {
+        auto query = utility::entityToIndex(entity.id(), m_curve_eID_to_idx);
+
+        if (!query.first)
+            continue;
+
+        for (auto const& constraint_point : m_data[query.second].m_constraint_points)
+        {
+            m_cp_eID_to_curve_idx.erase(constraint_point.m_entity.id());
+            m_bitangent_eID_to_cp_eID.erase(constraint_point.m_lh_bitangent_entity.id());
+            m_bitangent_eID_to_cp_eID.erase(constraint_point.m_rh_bitangent_entity.id());
+        }
+
+        m_curve_eID_to_idx.erase(entity.id());
+        any_removed = true;
+    }
+
+    if (!any_removed)
+        return;
+
+    // compact remaining curves and update the mappings to their new indices
+    uint dst_idx = 0;
+    for (uint idx = 0; idx < m_data.size(); ++idx)
+    {
+        if (m_curve_eID_to_idx.find(m_data[idx].m_entity.id()) == m_curve_eID_to_idx.end())
+            continue;
+
+        if (dst_idx != idx)
+            m_data[dst_idx] = std::move(m_data[idx]);
+
+        m_curve_eID_to_idx[m_data[dst_idx].m_entity.id()] = dst_idx;
+        for (auto const& constraint_point : m_data[dst_idx].m_constraint_points)
+            m_cp_eID_to_curve_idx[constraint_point.m_entity.id()] = dst_idx;
+
+        ++dst_idx;
+    }
+
+    m_data.erase(m_data.begin() + dst_idx, m_data.end());
+}
+
 template<typename ResourceManagerType>
 std::pair<bool, uint> EngineCore::Graphics::Landscape::FeatureCurveComponentManager<ResourceManagerType>::getIndex(Entity entity) const
 {
@@ -0,0 +1,441 @@
+#ifndef MPMCQueue_hpp
+#define MPMCQueue_hpp
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <queue>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace EngineCore
+{
+    namespace Utility
+    {
+
+        /**
+         * Multi-producer, multi-consumer queue with the same interface as MTQueue.
+         * Push and pop are lock-free on a fixed size ring buffer (bounded MPMC queue after D. Vyukov,
+         * each slot carries a sequence number that tells producers and consumers whose turn it is).
+         * The mutex is only taken by consumers that have to block on an empty queue and by producers
+         * that have to notify them, as well as on the overflow path of unbounded queues.
+         * T has to be default constructible and move assignable, elements are popped by assignment.
+         */
+        template <class T>
+        class MPMCQueue
+        {
+        public:
+            enum class Capacity
+            {
+                BOUNDED,  ///< push blocks while the ring buffer is full
+                UNBOUNDED ///< push spills into a mutex protected overflow queue while the ring buffer is full
+            };
+
+            /**
+             * \param capacity Size of the ring buffer, rounded up to a power of two
+             * \param policy Behaviour of push on a full ring buffer
+             */
+            explicit MPMCQueue(size_t capacity = 4096, Capacity policy = Capacity::UNBOUNDED);
+            ~MPMCQueue();
+
+            MPMCQueue(MPMCQueue const& cpy) = delete;
+            MPMCQueue& operator=(MPMCQueue const& rhs) = delete;
+
+            /**
+             * Push new element to the queue.
+             * \param val Element to be inserted
+             */
+            void push(const T& val) { pushImpl(val); }
+
+            void push(T&& val) { pushImpl(std::move(val)); }
+
+            /**
+             * Try to push an element to the ring buffer, never blocks and never uses the overflow queue.
+             * \return Returns false if the ring buffer was full, in which case val is left untouched.
+             */
+            bool tryPush(T&& val);
+
+            /**
+             * Pop element from the queue. Method call blocks if queue is empty until
+             * a new element is inserted.
+             * \param val Element extracted from queue
+             */
+            void pop(T& val);
+
+            /**
+             * Variant of pop method using return value.
+             */
+            T pop();
+
+            /**
+             * Try to pop an element from the queue. Non-blocking but can wait for
+             * specified time for a new element to arrive if queue is empty.
+             * \param val Element extracted from the queue
+             * \param timeout Time that is waited for a new element (defaults to 0)
+             * \return Returns true if an element was succesfully extracted from queue.
+             */
+            bool tryPop(T& val, std::chrono::microseconds timeout = std::chrono::microseconds(0));
+
+            /**
+             * Move the elements that are in the queue at the time of the call to the back of out.
+             * Elements pushed while draining are left in the queue, so draining always terminates,
+             * even if producers keep pushing.
+             * \return Returns the number of extracted elements
+             */
+            size_t drain(std::vector<T>& out);
+
+            /**
+             * Check whether or not the queue is currently empty. Only a snapshot under concurrent access.
+             */
+            bool empty() const;
+
+            /**
+             * Approximate number of elements, only exact without concurrent access.
+             */
+            size_t size() const;
+
+        private:
+            struct Slot
+            {
+                std::atomic<size_t>            sequence;
+                alignas(T) unsigned char       storage[sizeof(T)];
+
+                T* get() { return std::launder(reinterpret_cast<T*>(storage)); }
+            };
+
+            template<typename U>
+            void pushImpl(U&& val);
+
+            /** Lock-free push to the ring buffer, returns false if it is full */
+            template<typename U>
+            bool tryPushRing(U&& val);
+
+            /** Lock-free pop from the ring buffer, returns false if it is empty */
+            bool tryPopRing(T& val);
+
+            /** Pop from ring buffer or overflow queue without blocking */
+            bool tryPopAny(T& val);
+
+            /** Pop from ring buffer or overflow queue, mutex_ has to be held by the caller */
+            bool tryPopLocked(T& val);
+
+            /**
+             * Check whether a slot of the ring buffer is reserved by a producer but not written yet.
+             * Overflow elements were pushed after such a slot, so they must not be taken before it.
+             */
+            bool hasPendingRingSlot() const;
+
+            /** Wake up consumers blocked in pop, if there are any */
+            void notifyConsumers();
+
+            std::unique_ptr<Slot[]>  slots_;
+            size_t                   mask_;
+            Capacity                 policy_;
+
+            alignas(64) std::atomic<size_t> enqueue_pos_;
+            alignas(64) std::atomic<size_t> dequeue_pos_;
+
+            /** Elements pushed while the ring buffer was full (unbounded queues only) */
+            alignas(64) std::atomic<size_t> overflow_cnt_;
+            std::queue<T>                   overflow_;
+
+            /** Consumers blocked in pop, producers skip the notification while there are none */
+            std::atomic_int                 waiting_cnt_;
+            mutable std::mutex              mutex_;
+            std::condition_variable         cvar_;
+        };
+
+        template<class T>
+        inline MPMCQueue<T>::MPMCQueue(size_t capacity, Capacity policy)
+            : policy_(policy), enqueue_pos_(0), dequeue_pos_(0), overflow_cnt_(0), waiting_cnt_(0)
+        {
+            // round capacity up to power of two for cheap index wrap around
+            size_t ring_capacity = 2;
+            while (ring_capacity < capacity) {
+                ring_capacity <<= 1;
+            }
+
+            slots_.reset(new Slot[ring_capacity]);
+            mask_ = ring_capacity - 1;
+
+            for (size_t i = 0; i < ring_capacity; ++i) {
+                slots_[i].sequence.store(i, std::memory_order_relaxed);
+            }
+        }
+
+        template<class T>
+        inline MPMCQueue<T>::~MPMCQueue()
+        {
+            T val;
+            while (tryPopRing(val)) {}
+        }
+
+        template<class T>
+        template<typename U>
+        inline void MPMCQueue<T>::pushImpl(U&& val)
+        {
+            if (policy_ == Capacity::UNBOUNDED)
+            {
+                // keep per-producer FIFO order, once something spilled over, everything follows it until drained
+                bool pushed = (overflow_cnt_.load(std::memory_order_acquire) == 0) && tryPushRing(std::forward<U>(val));
+
+                if (!pushed)
+                {
+                    std::lock_guard<std::mutex> lock(mutex_);
+                    overflow_.push(std::forward<U>(val));
+                    overflow_cnt_.fetch_add(1, std::memory_order_release);
+                }
+            }
+            else
+            {
+                while (!tryPushRing(std::forward<U>(val))) {
+                    std::this_thread::yield();
+                }
+            }
+
+            notifyConsumers();
+        }
+
+        template<class T>
+        inline bool MPMCQueue<T>::tryPush(T&& val)
+        {
+            if (!tryPushRing(std::move(val))) {
+                return false;
+            }
+
+            notifyConsumers();
+            return true;
+        }
+
+        template<class T>
+        template<typename U>
+        inline bool MPMCQueue<T>::tryPushRing(U&& val)
+        {
+            size_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+            Slot* slot;
+
+            for (;;)
+            {
+                slot = &slots_[pos & mask_];
+                size_t seq = slot->sequence.load(std::memory_order_acquire);
+                intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+
+                if (diff == 0)
+                {
+                    if (enqueue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                        break;
+                    }
+                }
+                else if (diff < 0)
+                {
+                    // slot still holds the element from one lap ago
+                    return false;
+                }
+                else
+                {
+                    pos = enqueue_pos_.load(std::memory_order_relaxed);
+                }
+            }
+
+            ::new (static_cast<void*>(slot->storage)) T(std::forward<U>(val));
+            slot->sequence.store(pos + 1, std::memory_order_release);
+
+            return true;
+        }
+
+        template<class T>
+        inline bool MPMCQueue<T>::tryPopRing(T& val)
+        {
+            size_t pos = dequeue_pos_.load(std::memory_order_relaxed);
+            Slot* slot;
+
+            for (;;)
+            {
+                slot = &slots_[pos & mask_];
+                size_t seq = slot->sequence.load(std::memory_order_acquire);
+                intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1);
+
+                if (diff == 0)
+                {
+                    if (dequeue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                        break;
+                    }
+                }
+                else if (diff < 0)
+                {
+                    // slot not written yet
+                    return false;
+                }
+                else
+                {
+                    pos = dequeue_pos_.load(std::memory_order_relaxed);
+                }
+            }
+
+            val = std::move(*slot->get());
+            slot->get()->~T();
+            slot->sequence.store(pos + mask_ + 1, std::memory_order_release);
+
+            return true;
+        }
+
+        template<class T>
+        inline bool MPMCQueue<T>::tryPopAny(T& val)
+        {
+            if (tryPopRing(val)) {
+                return true;
+            }
+
+            if (overflow_cnt_.load(std::memory_order_acquire) > 0)
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                return tryPopLocked(val);
+            }
+
+            return false;
+        }
+
+        template<class T>
+        inline bool MPMCQueue<T>::tryPopLocked(T& val)
+        {
+            // the ring buffer comes first, elements only spill over once it is full
+            if (tryPopRing(val)) {
+                return true;
+            }
+
+            if (!overflow_.empty() && !hasPendingRingSlot())
+            {
+                val = std::move(overflow_.front());
+                overflow_.pop();
+                overflow_cnt_.fetch_sub(1, std::memory_order_release);
+                return true;
+            }
+
+            return false;
+        }
+
+        template<class T>
+        inline bool MPMCQueue<T>::hasPendingRingSlot() const
+        {
+            return dequeue_pos_.load(std::memory_order_acquire) < enqueue_pos_.load(std::memory_order_acquire);
+        }
+
+        template<class T>
+        inline void MPMCQueue<T>::notifyConsumers()
+        {
+            // pairs with the fence in tryPop, either the consumer sees the new element or we see the consumer
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+
+            if (waiting_cnt_.load(std::memory_order_relaxed) > 0)
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                cvar_.notify_all();
+            }
+        }
+
+        template<class T>
+        inline void MPMCQueue<T>::pop(T& val)
+        {
+            if (tryPopAny(val)) {
+                return;
+            }
+
+            waiting_cnt_.fetch_add(1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                cvar_.wait(lock, [this, &val] { return tryPopLocked(val); });
+            }
+            waiting_cnt_.fetch_sub(1, std::memory_order_relaxed);
+        }
+
+        template<class T>
+        inline T MPMCQueue<T>::pop()
+        {
+            T val;
+            pop(val);
+            return val;
+        }
+
+        template<class T>
+        inline bool MPMCQueue<T>::tryPop(T& val, std::chrono::microseconds timeout)
+        {
+            if (tryPopAny(val)) {
+                return true;
+            }
+
+            if (timeout.count() == 0) {
+                return false;
+            }
+
+            bool success;
+
+            waiting_cnt_.fetch_add(1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                success = cvar_.wait_for(lock, timeout, [this, &val] { return tryPopLocked(val); });
+            }
+            waiting_cnt_.fetch_sub(1, std::memory_order_relaxed);
+
+            return success;
+        }
+
+        template<class T>
+        inline size_t MPMCQueue<T>::drain(std::vector<T>& out)
+        {
+            size_t cnt = size();
+            size_t drained_cnt = 0;
+
+            out.reserve(out.size() + cnt);
+
+            T val;
+            while ((drained_cnt < cnt) && tryPopRing(val))
+            {
+                out.push_back(std::move(val));
+                ++drained_cnt;
+            }
+
+            if ((drained_cnt < cnt) && (overflow_cnt_.load(std::memory_order_acquire) > 0) && !hasPendingRingSlot())
+            {
+                // take the overflow batch under a single lock
+                std::lock_guard<std::mutex> lock(mutex_);
+
+                while ((drained_cnt < cnt) && !overflow_.empty())
+                {
+                    out.push_back(std::move(overflow_.front()));
+                    overflow_.pop();
+                    overflow_cnt_.fetch_sub(1, std::memory_order_release);
+                    ++drained_cnt;
+                }
+            }
+
+            return drained_cnt;
+        }
+
+        template<class T>
+        inline bool MPMCQueue<T>::empty() const
+        {
+            return size() == 0;
+        }
+
+        template<class T>
+        inline size_t MPMCQueue<T>::size() const
+        {
+            size_t dequeue_pos = dequeue_pos_.load(std::memory_order_acquire);
+            size_t enqueue_pos = enqueue_pos_.load(std::memory_order_acquire);
+            size_t ring_size = enqueue_pos > dequeue_pos ? enqueue_pos - dequeue_pos : 0;
+
+            return ring_size + overflow_cnt_.load(std::memory_order_acquire);
+        }
+
+    }
+}
+
+#endif // !MPMCQueue_hpp
@@ -39,7 +39,7 @@ namespace EngineCore
             {
                 std::lock_guard<std::mutex> lock(m_mutex);
 
-                m_queue.push(val);
+                m_queue.push(std::move(val));
                 m_cvar.notify_one();
             }
 
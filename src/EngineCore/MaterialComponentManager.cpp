@@ -38,6 +38,13 @@ void EngineCore::Graphics::MaterialComponentManager::addComponent(
         std::vector<std::pair<TextureSemantic, ResourceID>>());
 }
 
+void EngineCore::Graphics::MaterialComponentManager::deleteComponents(std::span<Entity const> entities)
+{
+    std::unique_lock<std::shared_mutex> lock(m_data_mutex);
+
+    eraseComponents(entities, m_component_data);
+}
+
 EngineCore::Graphics::ResourceID EngineCore::Graphics::MaterialComponentManager::getTextures(size_t component_idx, TextureSemantic semantic) const
 {
     std::shared_lock<std::shared_mutex> lock(m_data_mutex);
@@ -50,6 +50,8 @@ namespace EngineCore
                 float                roughness,
                 ResourceIDContainer  textures);
 
+            void deleteComponents(std::span<Entity const> entities) override;
+
             inline std::array<float, 4> getAlbedoColour(size_t idx) const {
                 std::shared_lock<std::shared_mutex> lock(m_data_mutex);
 
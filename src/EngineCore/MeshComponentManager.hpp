@@ -56,6 +56,8 @@ namespace EngineCore
                 uint32_t    base_vertex
             );
 
+            void deleteComponents(std::span<Entity const> entities) override;
+
             template<typename VertexContainer, typename IndexContainer>
             void updateComponent(
                 Entity const& entity,
@@ -315,6 +317,14 @@ namespace EngineCore
 
         }
 
+        template<typename ResourceManagerType>
+        inline void MeshComponentManager<ResourceManagerType>::deleteComponents(std::span<Entity const> entities)
+        {
+            std::unique_lock<std::shared_mutex> lock(m_data_mutex);
+
+            eraseComponents(entities, m_component_data);
+        }
+
         template<typename ResourceManagerType>
         inline ResourceID MeshComponentManager<ResourceManagerType>::getMeshResourceID(Entity const& entity, size_t sub_idx) const
         {
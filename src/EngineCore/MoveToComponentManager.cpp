@@ -20,7 +20,21 @@ size_t EngineCore::Animation::MoveToComponentManager::addComponent(Entity entity
 
 void EngineCore::Animation::MoveToComponentManager::deleteComponent(Entity entity)
 {
-    //TODO
+    auto index = getIndex(entity.id());
+
+    if (index == Utility::SingleInstanceIndexMap::invalid_index) {
+        return;
+    }
+
+    data_.deleteComponent(index);
+    removeIndex(entity.id());
+}
+
+void EngineCore::Animation::MoveToComponentManager::deleteComponents(std::span<Entity const> entities)
+{
+    for (auto entity : entities) {
+        deleteComponent(entity);
+    }
 }
 
 size_t EngineCore::Animation::MoveToComponentManager::getComponentCount() const
@@ -40,6 +54,11 @@ EngineCore::Animation::MoveToComponentManager::Data const& EngineCore::Animation
     return data_(indices.first, indices.second);
 }
 
+size_t EngineCore::Animation::MoveToComponentManager::getComponentPageCount() const
+{
+    return data_.getUsedPageCount();
+}
+
 void EngineCore::Animation::MoveToComponentManager::setTargetPosition(Entity entity, Vec3 target_position)
 {
     auto idx = getIndex(entity.id());
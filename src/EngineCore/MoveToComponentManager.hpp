@@ -39,12 +39,27 @@ namespace EngineCore
 
             void deleteComponent(Entity entity);
 
+            void deleteComponents(std::span<Entity const> entities) override;
+
             size_t getComponentCount() const;
 
             bool checkComponent(size_t index) const;
 
             Data const& getComponent(size_t index) const;
 
+            /** Number of component pages, i.e. the page range for forEachComponent */
+            size_t getComponentPageCount() const;
+
+            /**
+             * Call fn(index, component) for every live component in the pages [page_begin, page_end).
+             * Disjoint page ranges can be processed concurrently.
+             */
+            template<typename Function>
+            void forEachComponent(size_t page_begin, size_t page_end, Function&& fn) const
+            {
+                data_.forEachPage(page_begin, page_end, std::forward<Function>(fn));
+            }
+
             void setTargetPosition(Entity entity, Vec3 target_position);
 
             void setTargetPosition(size_t index, Vec3 target_position);
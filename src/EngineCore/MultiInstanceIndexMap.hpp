@@ -0,0 +1,409 @@
+#ifndef MultiInstanceIndexMap_hpp
+#define MultiInstanceIndexMap_hpp
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace EngineCore {
+    namespace Utility {
+
+        /**
+         * Maps entity ids to the indices of their components, for managers that allow several components per entity.
+         * Lookups read an immutable flat table (sorted entity ids, offsets and a packed index array) without locking
+         * and without allocating. Added indices are collected and merged into a new table on the next lookup.
+         */
+        class MultiInstanceIndexMap
+        {
+        private:
+            struct Table
+            {
+                /** Sorted, unique */
+                std::vector<unsigned int> entity_ids;
+                /** Indices of entity_ids[i] are indices[offsets[i]] to indices[offsets[i+1]] */
+                std::vector<size_t>       offsets;
+                std::vector<size_t>       indices;
+            };
+
+        public:
+            /** Marks removed entries in remap */
+            static constexpr size_t invalid_index = (std::numeric_limits<size_t>::max)();
+
+            /**
+             * Indices of the components of one entity. Keeps the table it points into alive, so it stays
+             * valid regardless of later changes to the map (which it does not reflect).
+             */
+            class IndexRange
+            {
+            public:
+                typedef size_t const* const_iterator;
+                typedef const_iterator iterator;
+
+                IndexRange() = default;
+
+                const_iterator begin() const { return span_.data(); }
+                const_iterator end() const { return span_.data() + span_.size(); }
+
+                size_t size() const { return span_.size(); }
+                bool empty() const { return span_.empty(); }
+
+                size_t front() const { assert(!empty()); return span_.front(); }
+                size_t back() const { assert(!empty()); return span_.back(); }
+
+                size_t operator[](size_t i) const { return span_[i]; }
+
+                std::span<size_t const> getSpan() const { return span_; }
+
+            private:
+                friend class MultiInstanceIndexMap;
+
+                IndexRange(std::shared_ptr<Table const> table, std::span<size_t const> span)
+                    : table_(std::move(table)), span_(span) {}
+
+                std::shared_ptr<Table const> table_;
+                std::span<size_t const>      span_;
+            };
+
+            MultiInstanceIndexMap() : table_(std::make_shared<Table const>(Table{ {}, { 0 }, {} })), pending_cnt_(0) {}
+            ~MultiInstanceIndexMap() = default;
+
+            MultiInstanceIndexMap(MultiInstanceIndexMap const& cpy) = delete;
+            MultiInstanceIndexMap& operator=(MultiInstanceIndexMap const& rhs) = delete;
+
+            void addIndex(unsigned int entity_id, size_t index);
+
+            /**
+             * Add several entries at once, entity_ids[i] is mapped to indices[i]. Takes the lock once.
+             */
+            void addIndices(std::span<unsigned int const> entity_ids, std::span<size_t const> indices);
+
+            /**
+             * Replace all entries, with index i mapped to entity_ids[i].
+             */
+            void rebuild(std::span<unsigned int const> entity_ids);
+
+            /**
+             * Remove all entries of the given entities. Builds one new table for the whole batch.
+             */
+            void removeIndices(std::span<unsigned int const> entity_ids);
+
+            /**
+             * Move all entries to new indices, e.g. after the component data was reordered: index i becomes new_indices[i],
+             * entries mapped to invalid_index are removed. Builds one new table without sorting.
+             */
+            void remap(std::span<size_t const> new_indices);
+
+            IndexRange getIndex(unsigned int entity_id) const;
+
+            /**
+             * Look up the indices of several entities at once, ranges[i] receives the result for entity_ids[i].
+             * Reads a single table for the whole batch.
+             */
+            void getIndices(std::span<unsigned int const> entity_ids, std::span<IndexRange> ranges) const;
+
+            /**
+             * Number of entities with at least one entry.
+             */
+            size_t getEntityCount() const;
+
+            /**
+             * Append the ids of all entities with entries, sorted.
+             */
+            void getEntityIds(std::vector<unsigned int>& entity_ids) const;
+
+        private:
+            /** Merge pending additions into a new table, if there are any */
+            void publish() const;
+
+            /** Same as publish, for callers already holding mutex_ */
+            void publishLocked() const;
+
+            mutable std::atomic<std::shared_ptr<Table const>> table_;
+
+            /** Added (entity id, index) pairs not yet merged into the table, in order of addition */
+            mutable std::vector<std::pair<unsigned int, size_t>> pending_;
+            mutable std::atomic_size_t                           pending_cnt_;
+            mutable std::mutex                                   mutex_;
+        };
+
+        inline void MultiInstanceIndexMap::addIndex(unsigned int entity_id, size_t index)
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+
+            pending_.push_back({ entity_id, index });
+            pending_cnt_.store(pending_.size(), std::memory_order_release);
+        }
+
+        inline void MultiInstanceIndexMap::addIndices(std::span<unsigned int const> entity_ids, std::span<size_t const> indices)
+        {
+            assert(indices.size() >= entity_ids.size());
+
+            std::unique_lock<std::mutex> lock(mutex_);
+
+            pending_.reserve(pending_.size() + entity_ids.size());
+            for (size_t i = 0; i < entity_ids.size(); ++i) {
+                pending_.push_back({ entity_ids[i], indices[i] });
+            }
+            pending_cnt_.store(pending_.size(), std::memory_order_release);
+        }
+
+        inline void MultiInstanceIndexMap::rebuild(std::span<unsigned int const> entity_ids)
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+
+            pending_.clear();
+            pending_cnt_.store(0, std::memory_order_release);
+
+            std::vector<std::pair<unsigned int, size_t>> entries;
+            entries.reserve(entity_ids.size());
+            for (size_t idx = 0; idx < entity_ids.size(); ++idx) {
+                entries.push_back({ entity_ids[idx], idx });
+            }
+
+            std::sort(entries.begin(), entries.end());
+
+            auto table = std::make_shared<Table>();
+            table->offsets.push_back(0);
+            table->indices.reserve(entries.size());
+
+            for (auto const& entry : entries)
+            {
+                if (table->entity_ids.empty() || table->entity_ids.back() != entry.first)
+                {
+                    table->entity_ids.push_back(entry.first);
+                    table->offsets.push_back(table->offsets.back());
+                }
+
+                table->indices.push_back(entry.second);
+                ++table->offsets.back();
+            }
+
+            table_.store(std::move(table), std::memory_order_release);
+        }
+
+        inline void MultiInstanceIndexMap::removeIndices(std::span<unsigned int const> entity_ids)
+        {
+            if (entity_ids.empty()) {
+                return;
+            }
+
+            std::vector<unsigned int> removed_ids(entity_ids.begin(), entity_ids.end());
+            std::sort(removed_ids.begin(), removed_ids.end());
+
+            std::unique_lock<std::mutex> lock(mutex_);
+
+            // merge pending additions first, they might belong to removed entities
+            publishLocked();
+
+            std::shared_ptr<Table const> old_table = table_.load(std::memory_order_acquire);
+
+            auto table = std::make_shared<Table>();
+            table->entity_ids.reserve(old_table->entity_ids.size());
+            table->offsets.reserve(old_table->offsets.size());
+            table->indices.reserve(old_table->indices.size());
+            table->offsets.push_back(0);
+
+            // both id lists are sorted, so removed entities are found in a single pass
+            auto removed = removed_ids.begin();
+
+            for (size_t old_i = 0; old_i < old_table->entity_ids.size(); ++old_i)
+            {
+                unsigned int entity_id = old_table->entity_ids[old_i];
+
+                while (removed != removed_ids.end() && *removed < entity_id) {
+                    ++removed;
+                }
+
+                if (removed != removed_ids.end() && *removed == entity_id) {
+                    continue;
+                }
+
+                table->entity_ids.push_back(entity_id);
+                table->indices.insert(table->indices.end(),
+                    old_table->indices.begin() + old_table->offsets[old_i],
+                    old_table->indices.begin() + old_table->offsets[old_i + 1]);
+                table->offsets.push_back(table->indices.size());
+            }
+
+            table_.store(std::move(table), std::memory_order_release);
+        }
+
+        inline void MultiInstanceIndexMap::remap(std::span<size_t const> new_indices)
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+
+            // pending additions refer to the old indices as well
+            publishLocked();
+
+            std::shared_ptr<Table const> old_table = table_.load(std::memory_order_acquire);
+
+            auto table = std::make_shared<Table>();
+            table->entity_ids.reserve(old_table->entity_ids.size());
+            table->offsets.reserve(old_table->offsets.size());
+            table->indices.reserve(old_table->indices.size());
+            table->offsets.push_back(0);
+
+            for (size_t old_i = 0; old_i < old_table->entity_ids.size(); ++old_i)
+            {
+                for (size_t j = old_table->offsets[old_i]; j < old_table->offsets[old_i + 1]; ++j)
+                {
+                    assert(old_table->indices[j] < new_indices.size());
+
+                    size_t index = new_indices[old_table->indices[j]];
+                    if (index != invalid_index) {
+                        table->indices.push_back(index);
+                    }
+                }
+
+                // entities without remaining entries are dropped
+                if (table->indices.size() != table->offsets.back())
+                {
+                    table->entity_ids.push_back(old_table->entity_ids[old_i]);
+                    table->offsets.push_back(table->indices.size());
+                }
+            }
+
+            table_.store(std::move(table), std::memory_order_release);
+        }
+
+        inline MultiInstanceIndexMap::IndexRange MultiInstanceIndexMap::getIndex(unsigned int entity_id) const
+        {
+            if (pending_cnt_.load(std::memory_order_acquire) != 0) {
+                publish();
+            }
+
+            std::shared_ptr<Table const> table = table_.load(std::memory_order_acquire);
+
+            auto query = std::lower_bound(table->entity_ids.begin(), table->entity_ids.end(), entity_id);
+
+            if (query == table->entity_ids.end() || *query != entity_id) {
+                return IndexRange();
+            }
+
+            size_t i = static_cast<size_t>(query - table->entity_ids.begin());
+            std::span<size_t const> span(table->indices.data() + table->offsets[i], table->offsets[i + 1] - table->offsets[i]);
+
+            return IndexRange(std::move(table), span);
+        }
+
+        inline void MultiInstanceIndexMap::getIndices(std::span<unsigned int const> entity_ids, std::span<IndexRange> ranges) const
+        {
+            assert(ranges.size() >= entity_ids.size());
+
+            if (pending_cnt_.load(std::memory_order_acquire) != 0) {
+                publish();
+            }
+
+            std::shared_ptr<Table const> table = table_.load(std::memory_order_acquire);
+
+            for (size_t i = 0; i < entity_ids.size(); ++i)
+            {
+                auto query = std::lower_bound(table->entity_ids.begin(), table->entity_ids.end(), entity_ids[i]);
+
+                if (query == table->entity_ids.end() || *query != entity_ids[i])
+                {
+                    ranges[i] = IndexRange();
+                    continue;
+                }
+
+                size_t j = static_cast<size_t>(query - table->entity_ids.begin());
+                ranges[i] = IndexRange(table, std::span<size_t const>(table->indices.data() + table->offsets[j], table->offsets[j + 1] - table->offsets[j]));
+            }
+        }
+
+        inline size_t MultiInstanceIndexMap::getEntityCount() const
+        {
+            if (pending_cnt_.load(std::memory_order_acquire) != 0) {
+                publish();
+            }
+
+            return table_.load(std::memory_order_acquire)->entity_ids.size();
+        }
+
+        inline void MultiInstanceIndexMap::getEntityIds(std::vector<unsigned int>& entity_ids) const
+        {
+            if (pending_cnt_.load(std::memory_order_acquire) != 0) {
+                publish();
+            }
+
+            std::shared_ptr<Table const> table = table_.load(std::memory_order_acquire);
+
+            entity_ids.insert(entity_ids.end(), table->entity_ids.begin(), table->entity_ids.end());
+        }
+
+        inline void MultiInstanceIndexMap::publish() const
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+
+            publishLocked();
+        }
+
+        inline void MultiInstanceIndexMap::publishLocked() const
+        {
+            // another reader might have published in the meantime
+            if (pending_.empty()) {
+                return;
+            }
+
+            // order by entity, but keep the order of addition per entity
+            std::stable_sort(pending_.begin(), pending_.end(), [](auto const& lhs, auto const& rhs) { return lhs.first < rhs.first; });
+
+            std::shared_ptr<Table const> old_table = table_.load(std::memory_order_acquire);
+
+            auto table = std::make_shared<Table>();
+            table->entity_ids.reserve(old_table->entity_ids.size() + pending_.size());
+            table->offsets.reserve(old_table->offsets.size() + pending_.size());
+            table->indices.reserve(old_table->indices.size() + pending_.size());
+            table->offsets.push_back(0);
+
+            // merge the old table with the pending additions, the old indices of an entity come first
+            size_t old_i = 0;
+            size_t pending_i = 0;
+
+            while (old_i < old_table->entity_ids.size() || pending_i < pending_.size())
+            {
+                unsigned int entity_id;
+                if (pending_i == pending_.size() || (old_i < old_table->entity_ids.size() && old_table->entity_ids[old_i] <= pending_[pending_i].first)) {
+                    entity_id = old_table->entity_ids[old_i];
+                }
+                else {
+                    entity_id = pending_[pending_i].first;
+                }
+
+                table->entity_ids.push_back(entity_id);
+
+                if (old_i < old_table->entity_ids.size() && old_table->entity_ids[old_i] == entity_id)
+                {
+                    table->indices.insert(table->indices.end(),
+                        old_table->indices.begin() + old_table->offsets[old_i],
+                        old_table->indices.begin() + old_table->offsets[old_i + 1]);
+                    ++old_i;
+                }
+
+                while (pending_i < pending_.size() && pending_[pending_i].first == entity_id)
+                {
+                    table->indices.push_back(pending_[pending_i].second);
+                    ++pending_i;
+                }
+
+                table->offsets.push_back(table->indices.size());
+            }
+
+            pending_.clear();
+
+            // publish the table before clearing the counter, readers seeing no pending additions see the new table
+            table_.store(std::move(table), std::memory_order_release);
+            pending_cnt_.store(0, std::memory_order_release);
+        }
+
+    }
+}
+
+#endif // !MultiInstanceIndexMap_hpp
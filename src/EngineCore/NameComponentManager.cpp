@@ -26,6 +26,13 @@ namespace EngineCore
             m_data.push_back(Data(entity, debug_name));
         }
 
+        void NameComponentManager::deleteComponents(std::span<Entity const> entities)
+        {
+            std::unique_lock<std::mutex> lock(m_dataAccess_mutex);
+
+            eraseComponents(entities, m_data);
+        }
+
         std::string NameComponentManager::getDebugName(Entity entity) const
         {
             auto query = getIndex(entity);
@@ -34,6 +34,8 @@ namespace EngineCore
             void addComponent(Entity entity, std::string const& debug_name);
             void addComponent(Entity entity, std::string && debug_name);
 
+            void deleteComponents(std::span<Entity const> entities) override;
+
             std::string getDebugName(Entity entity) const;
             std::string getDebugName(size_t index) const;
         };
@@ -111,9 +111,18 @@ public:
 
         uint idx = static_cast<int>(m_data.size());
 
+        addIndex(entity.id(), idx);
+
         m_data.push_back(Data(entity, wave_height, patch_size, grid_size));
     }
 
+    void deleteComponents(std::span<Entity const> entities) override
+    {
+        std::unique_lock<std::shared_mutex> lock(m_data_access_mutex);
+
+        eraseComponents(entities, m_data);
+    }
+
     size_t getComponentCount() const
     {
         std::shared_lock<std::shared_mutex> lock(m_data_access_mutex);
@@ -79,11 +79,11 @@ void EngineCore::Graphics::OpenGL::addAtmosphereRenderPass(Common::Frame& frame,
 
             data.view_matrix = glm::inverse(transform_mngr.getWorldTransformation(camera_transform_idx));
 
-            //cam_mngr.setAspectRatio(camera_idx, static_cast<float>(frame.m_window_width) / static_cast<float>(frame.m_window_height));
-            cam_mngr.setNear(camera_idx, 1.0f);
-            cam_mngr.setFar(camera_idx, 6800000.0);
-            cam_mngr.updateProjectionMatrix(camera_idx);
-            data.proj_matrix = cam_mngr.getProjectionMatrix(camera_idx);
+            // atmosphere needs a far larger depth range than the camera, computed locally so that
+            // passes reading the camera during their (concurrent) data setup never see the extended range
+            data.proj_matrix = glm::perspective(cam_mngr.getFovy(camera_idx), cam_mngr.getAspectRatio(camera_idx), 1.0f, 6800000.0f);
+
+            // afterwards the camera is reset to the default depth range, as before
             cam_mngr.setNear(camera_idx, 0.1f);
             cam_mngr.setFar(camera_idx, 1000.0);
             cam_mngr.updateProjectionMatrix(camera_idx);
@@ -366,6 +366,7 @@ void EngineCore::Graphics::OpenGL::addAtmosphereRenderPass(Common::Frame& frame,
             }
             
             resources.atmosphere_proxy_mesh.resource->draw(instance_counter);
-        }
+        },
+        { "GeometryPass" }
     );
 }
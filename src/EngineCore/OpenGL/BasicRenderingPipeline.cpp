@@ -27,7 +27,8 @@ namespace EngineCore
             void setupBasicForwardRenderingPipeline(
                 Common::Frame & frame,
                 WorldState & world_state,
-                ResourceManager & resource_mngr)
+                ResourceManager & resource_mngr,
+                Utility::TaskScheduler * task_scheduler)
             {
                 struct GeomPassData
                 {
@@ -98,13 +99,13 @@ namespace EngineCore
                     data.proj_matrix = cam_mngr.getProjectionMatrix(camera_idx);
 
                     // set per object data
-                    auto objs = renderTask_mngr.getComponentDataCopy();
+                    auto objs = renderTask_mngr.getComponentDataSnapshot();
 
                     ResourceID current_prgm = resource_mngr.invalidResourceID();
                     ResourceID current_mesh = resource_mngr.invalidResourceID();
 
                     // iterate all objects
-                    for (auto& obj : objs)
+                    for (auto& obj : *objs)
                     {
                         // create a new batch for each resource change
                         if (obj.shader_prgm != current_prgm || obj.mesh != current_mesh)
@@ -379,10 +380,17 @@ namespace EngineCore
                     ImGui::End();
                 }
                 );
+
+                if (task_scheduler != nullptr) {
+                    frame.setupRenderPassData(*task_scheduler);
+                }
+                else {
+                    frame.setupRenderPassData();
+                }
             }
 
 
-            void setupBasicDeferredRenderingPipeline(Common::Frame& frame, WorldState& world_state, ResourceManager& resource_mngr)
+            void setupBasicDeferredRenderingPipeline(Common::Frame& frame, WorldState& world_state, ResourceManager& resource_mngr, Utility::TaskScheduler* task_scheduler)
             {
                 // Experimenting with taging framebuffer color attachements
                 enum class ColorAttachmentSemantic : uint32_t
@@ -501,13 +509,13 @@ namespace EngineCore
                         resources.m_render_target = resource_mngr.getFramebufferObject("GBuffer");
 
                         // set per object data
-                        auto objs = renderTask_mngr.getComponentDataCopy();
+                        auto objs = renderTask_mngr.getComponentDataSnapshot();
 
                         ResourceID current_prgm = resource_mngr.invalidResourceID();
                         ResourceID current_mesh = resource_mngr.invalidResourceID();
 
                         // iterate all objects
-                        for (auto& obj : objs)
+                        for (auto& obj : *objs)
                         {
                             // create a new batch for each resource change
                             if (obj.shader_prgm != current_prgm || obj.mesh != current_mesh)
@@ -520,8 +528,8 @@ namespace EngineCore
                                 data.static_mesh_drawCommands.push_back(std::vector<GeomPassData::DrawElementsCommand>());
 
                                 // potential optimization for large scenes: reserve enough memory beforehand
-                                //data.static_mesh_params.back().reserve(objs.size());
-                                //data.static_mesh_drawCommands.back().reserve(objs.size());
+                                //data.static_mesh_params.back().reserve(objs->size());
+                                //data.static_mesh_drawCommands.back().reserve(objs->size());
 
                                 data.mtl_tx_cache.push_back(std::vector<GeomPassData::MaterialTextures>());
 
@@ -803,31 +811,31 @@ namespace EngineCore
                         data.m_aspect_fovy = Vec2(aspect_ratio, fovy);
                         data.m_exposure = cam_mngr.getExposure(camera_idx);
 
-                        // gather data from lightsource components
-                        uint pointlight_cnt = pointlight_mngr.getComponentCount();
-                        data.m_pointlight_data.reserve(pointlight_cnt);
-                        for (int i = 0; i < pointlight_cnt; i++)
-                        {
-                            if (true) // if active
-                            {
-                                Vec3 position = transform_mngr.getWorldPosition(pointlight_mngr.getEntity(i));
-                                float intensity = pointlight_mngr.getLumen(i);
-                                Vec3 colour = pointlight_mngr.getColour(i);
-                                data.m_pointlight_data.push_back({ Vec4(position, 1.0), colour, intensity });
+                        // gather data from lightsource components, lights without a transform are skipped
+                        data.m_pointlight_data.reserve(pointlight_mngr.getComponentCount());
+                        world_state.query<Common::TransformComponentManager, Graphics::PointlightComponentManager>().forEach(
+                            [&data, &transform_mngr, &pointlight_mngr](Entity, size_t transform_idx, Utility::MultiInstanceIndexMap::IndexRange const& pointlight_indices) {
+                                Vec3 position = transform_mngr.getWorldPosition(transform_idx);
+                                for (auto i : pointlight_indices)
+                                {
+                                    float intensity = pointlight_mngr.getLumen(static_cast<uint>(i));
+                                    Vec3 colour = pointlight_mngr.getColour(static_cast<uint>(i));
+                                    data.m_pointlight_data.push_back({ Vec4(position, 1.0), colour, intensity });
+                                }
                             }
-                        }
+                        );
 
-                        uint sunlight_cnt = sunlight_mngr.getComponentCount();
-                        data.m_sunlight_data.reserve(sunlight_cnt);
-                        for (int i = 0; i < sunlight_cnt; i++)
-                        {
-                            if (true) // if active
-                            {
-                                Vec3 position = transform_mngr.getWorldPosition(sunlight_mngr.getEntity(i));
-                                float intensity = sunlight_mngr.getLumen(i);
-                                data.m_sunlight_data.push_back(Vec4(position, intensity));
+                        data.m_sunlight_data.reserve(sunlight_mngr.getComponentCount());
+                        world_state.query<Common::TransformComponentManager, Graphics::SunlightComponentManager>().forEach(
+                            [&data, &transform_mngr, &sunlight_mngr](Entity, size_t transform_idx, Utility::MultiInstanceIndexMap::IndexRange const& sunlight_indices) {
+                                Vec3 position = transform_mngr.getWorldPosition(transform_idx);
+                                for (auto i : sunlight_indices)
+                                {
+                                    float intensity = sunlight_mngr.getLumen(static_cast<uint>(i));
+                                    data.m_sunlight_data.push_back(Vec4(position, intensity));
+                                }
                             }
-                        }
+                        );
 
                         // try to get resources early
                         resources.m_lighting_prgm = resource_mngr.getShaderProgramResource("rendering_pipeline_lighting");
@@ -962,7 +970,9 @@ namespace EngineCore
                               std::cerr << "GL error in lighting pass : " << gl_err << std::endl;
                       
                           glMemoryBarrier(GL_TEXTURE_FETCH_BARRIER_BIT);
-                    }
+                    },
+                    // reads the camera aspect ratio updated in the geometry pass data setup
+                    { "GeometryPass" }
                 );
 
                 // experimental: insert render pass
@@ -1080,6 +1090,13 @@ namespace EngineCore
                         glDrawArrays(GL_TRIANGLES, 0, 6);
                     }
                 );
+
+                if (task_scheduler != nullptr) {
+                    frame.setupRenderPassData(*task_scheduler);
+                }
+                else {
+                    frame.setupRenderPassData();
+                }
             }
         }
     }
@@ -2,6 +2,7 @@
 #define BasicRenderingPipeline
 
 #include "../Frame.hpp"
+#include "../TaskScheduler.hpp"
 #include "../WorldState.hpp"
 #include "ResourceManager.hpp"
 
@@ -11,15 +12,21 @@ namespace EngineCore
     {
         namespace OpenGL
         {
+            /**
+             * Add the render passes of the pipeline to the frame and set up their data.
+             * If a task scheduler is given, the data setup of the passes runs concurrently on its worker threads.
+             */
             void setupBasicForwardRenderingPipeline(
-                Common::Frame&   frame,
-                WorldState&      world_state,
-                ResourceManager& resource_mngr);
+                Common::Frame&           frame,
+                WorldState&              world_state,
+                ResourceManager&         resource_mngr,
+                Utility::TaskScheduler*  task_scheduler = nullptr);
 
             void setupBasicDeferredRenderingPipeline(
                 Common::Frame& frame,
                 WorldState& world_state,
-                ResourceManager& resource_mngr);
+                ResourceManager& resource_mngr,
+                Utility::TaskScheduler* task_scheduler = nullptr);
 
             /** Experimenting with new Renderer architecture */
             //void setupBasicRenderingPipeline(
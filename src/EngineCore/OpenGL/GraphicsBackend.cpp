@@ -2,6 +2,7 @@
 
 #include <iostream>
 
+#include "CpuTopology.hpp"
 #include "ResourceManager.hpp"
 
 #ifdef _WIN32
@@ -265,6 +266,11 @@ namespace EngineCore
 
             void GraphicsBackend::run(ResourceManager* resource_manager, Common::FrameManager<Common::Frame>* frame_manager)
             {
+                int render_thread_core = m_render_thread_core.load();
+                if (render_thread_core >= 0 && !Utility::CpuTopology::pinCurrentThread(render_thread_core)) {
+                    std::cerr << "Couldn't pin render thread to core " << render_thread_core << std::endl;
+                }
+
                 // Initialize GLFW
                 if (!glfwInit())
                 {
@@ -351,6 +357,15 @@ namespace EngineCore
                     ImGui_ImplGlfw_NewFrame();
                     ImGui::NewFrame();
 
+                    // Perform resource manager async tasks, rendering this frame may depend on them, so they run regardless of the budget
+                    m_singleExecution_tasks.submit([resource_manager]() {
+                        resource_manager->executeRenderThreadTasks();
+
+                        auto gl_err = glGetError();
+                        if (gl_err != GL_NO_ERROR)
+                            std::cerr << "GL error after resource manager tasks: " << gl_err << std::endl;
+                        }, Utility::RenderThreadScheduler::Priority::CRITICAL);
+
                     // Perform single execution tasks
                     processSingleExecutionTasks();
 
@@ -358,13 +373,6 @@ namespace EngineCore
                     if (gl_err != GL_NO_ERROR)
                         std::cerr << "GL error after single exection tasks: " << gl_err << std::endl;
 
-                    // Perform resource manager async tasks
-                    resource_manager->executeRenderThreadTasks();
-
-                    gl_err = glGetError();
-                    if (gl_err != GL_NO_ERROR)
-                        std::cerr << "GL error after resource manager tasks: " << gl_err << std::endl;
-
                     // TODO try getting update for render frame ?
 
                     // Get current frame for rendering
@@ -424,6 +432,9 @@ namespace EngineCore
                     }
 
 
+                    // Run data setup of passes that the frame creator did not set up yet
+                    frame.setupRenderPassData();
+
                     // Call buffer phase for each render pass
                     for (auto& render_pass : frame.m_render_passes)
                     {
@@ -470,36 +481,25 @@ namespace EngineCore
                 resource_manager->clearAllResources();
             }
 
-            void GraphicsBackend::addSingleExecutionGpuTask(std::function<void()> task)
+            void GraphicsBackend::addSingleExecutionGpuTask(std::function<void()> task, Utility::RenderThreadScheduler::Priority priority)
             {
-                m_singleExecution_tasks.push(task);
+                m_singleExecution_tasks.submit(std::move(task), priority);
             }
 
-            void GraphicsBackend::processSingleExecutionTasks()
+            void GraphicsBackend::setSingleExecutionTaskBudget(double budget_ms)
             {
-                auto start_time = std::chrono::steady_clock::now();
-
-                size_t task_cnt = m_singleExecution_tasks.size();
-
-                while (!m_singleExecution_tasks.empty())
-                {
-                    //auto t_0 = std::chrono::steady_clock::now();
-
-                    std::function<void()> task = m_singleExecution_tasks.pop();
-                    task();
-
-                    glFinish();
-
-                    auto t_1 = std::chrono::steady_clock::now();
-
-                    //std::chrono::duration<double, std::milli> task_time = (t_1 - t_0);
-                    //std::cout << "Task time: " << task_time.count() << std::endl;
+                m_singleExecution_budget.store(budget_ms);
+            }
 
-                    std::chrono::duration<double, std::milli> time = (t_1 - start_time);
+            void GraphicsBackend::setRenderThreadCore(int logical_core_id)
+            {
+                m_render_thread_core.store(logical_core_id);
+            }
 
-                    //if (time.count() > 33)
-                    //	break;
-                }
+            void GraphicsBackend::processSingleExecutionTasks()
+            {
+                // no glFinish between tasks, the budget only covers the time for issuing the GL commands
+                m_singleExecution_tasks.process(std::chrono::duration<double, std::milli>(m_singleExecution_budget.load()));
             }
 
             std::pair<int, int> GraphicsBackend::getActiveWindowResolution()
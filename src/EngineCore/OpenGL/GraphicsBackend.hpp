@@ -1,11 +1,12 @@
 #ifndef GraphicsBackend_hpp
 #define GraphicsBackend_hpp
 
+#include <atomic>
 #include <condition_variable>
 #include <functional>
 
 #include "Frame.hpp"
-#include "MTQueue.hpp"
+#include "RenderThreadScheduler.hpp"
 #include "InputEvent.hpp"
 
 struct GLFWwindow;
@@ -28,14 +29,31 @@ namespace EngineCore
             class GraphicsBackend
             {
             public:
-                GraphicsBackend() : m_active_window(nullptr), m_singleExecution_tasks(), m_window_created(false) {}
+                GraphicsBackend() : m_active_window(nullptr), m_singleExecution_tasks(), m_singleExecution_budget(8.0), m_render_thread_core(-1), m_window_created(false) {}
                 ~GraphicsBackend() = default;
 
                 /** Start and run graphics backend. Returns only after rendering window is closed. */
                 void run(ResourceManager* resource_manager, Common::FrameManager<Common::Frame>* frame_manager);
 
-                /** Add a task to the graphics backend that only has to be executed once */
-                void addSingleExecutionGpuTask(std::function<void()> task);
+                /**
+                 * Add a task to the graphics backend that only has to be executed once.
+                 * Tasks of the same priority are executed in the order they were added.
+                 */
+                void addSingleExecutionGpuTask(
+                    std::function<void()> task,
+                    Utility::RenderThreadScheduler::Priority priority = Utility::RenderThreadScheduler::Priority::STREAMING);
+
+                /** Set time per frame available for non-critical single execution tasks in milliseconds */
+                void setSingleExecutionTaskBudget(double budget_ms);
+
+                /**
+                 * Set the logical core the render thread pins itself to when run is called, e.g. the core
+                 * reserved by TaskScheduler::getRenderThreadCore. -1 (default) leaves the render thread unpinned.
+                 */
+                void setRenderThreadCore(int logical_core_id);
+
+                /** Access the render thread scheduler directly, e.g. for resuming jobs on the render thread */
+                Utility::RenderThreadScheduler& getSingleExecutionTaskScheduler() { return m_singleExecution_tasks; }
 
                 std::pair<int, int> getActiveWindowResolution();
 
@@ -54,8 +72,13 @@ namespace EngineCore
                 /** Pointer to active window */
                 GLFWwindow* m_active_window;
 
-                /** Thread-safe queue for tasks that have to be executed on the render thread, but only a single time */
-                Utility::MTQueue<std::function<void()>> m_singleExecution_tasks;
+                /** Tasks that have to be executed on the render thread, but only a single time */
+                Utility::RenderThreadScheduler m_singleExecution_tasks;
+                /** Time per frame available for non-critical single execution tasks in milliseconds */
+                std::atomic<double> m_singleExecution_budget;
+
+                /** Logical core the render thread is pinned to, -1 if unpinned */
+                std::atomic<int> m_render_thread_core;
 
                 bool m_window_created;
                 std::mutex m_window_creation_mutex;
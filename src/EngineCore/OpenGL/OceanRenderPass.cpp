@@ -815,6 +815,7 @@ void EngineCore::Graphics::OpenGL::addOceanRenderPass(Common::Frame& frame, Worl
             
                 resources.ocean_surface_mesh.resource->draw();
             }
-        }
+        },
+        { "GeometryPass" }
     );
 }
@@ -80,11 +80,12 @@ void EngineCore::Graphics::OpenGL::addSkinnedMeshRenderPass(Common::Frame& frame
 
             data.view_matrix = glm::inverse(transform_mngr.getWorldTransformation(camera_transform_idx));
 
+            // same update as in the geometry pass, which this pass's data setup waits for if present
             if (frame.m_window_width != 0 && frame.m_window_height != 0) {
                 cam_mngr.setAspectRatio(camera_idx, static_cast<float>(frame.m_window_width) / static_cast<float>(frame.m_window_height));
                 cam_mngr.updateProjectionMatrix(camera_idx);
-                data.proj_matrix = cam_mngr.getProjectionMatrix(camera_idx);
             }
+            data.proj_matrix = cam_mngr.getProjectionMatrix(camera_idx);
 
             // check for existing gBuffer
             resources.m_render_target = resource_mngr.getFramebufferObject("GBuffer");
@@ -93,13 +94,13 @@ void EngineCore::Graphics::OpenGL::addSkinnedMeshRenderPass(Common::Frame& frame
             resources.joint_matrices = resource_mngr.getBufferResource("skinnedMeshPass_joint_matrices_" + std::to_string(frame.m_frameID % 2));
 
             // set per object data
-            auto objs = renderTask_mngr.getComponentDataCopy();
+            auto objs = renderTask_mngr.getComponentDataSnapshot();
 
             ResourceID current_prgm = resource_mngr.invalidResourceID();
             ResourceID current_mesh = resource_mngr.invalidResourceID();
 
             // iterate all objects
-            for (auto& obj : objs)
+            for (auto& obj : *objs)
             {
                 // create a new batch for each resource change
                 if (obj.shader_prgm != current_prgm || obj.mesh != current_mesh)
@@ -306,7 +307,8 @@ void EngineCore::Graphics::OpenGL::addSkinnedMeshRenderPass(Common::Frame& frame
             //}
             //ImGui::Text("# batches (draw calls): %u ", batch_idx);
             //ImGui::End();
-        }
+        },
+        { "GeometryPass" }
     );
 
 }
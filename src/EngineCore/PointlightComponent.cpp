@@ -76,7 +76,20 @@ namespace EngineCore
 
         void PointlightComponentManager::deleteComponent(Entity entity)
         {
-            // std::unique_lock<std::shared_mutex> lock(m_data_access_mutex);
+            deleteComponents(std::span<Entity const>(&entity, 1));
+        }
+
+        void PointlightComponentManager::deleteComponents(std::span<Entity const> entities)
+        {
+            std::unique_lock<std::shared_mutex> lock(m_data_access_mutex);
+
+            m_data.used = static_cast<uint>(compactComponents(entities, m_data.used,
+                [this](size_t src_index, size_t dst_index) {
+                    m_data.entity[dst_index] = m_data.entity[src_index];
+                    m_data.light_colour[dst_index] = m_data.light_colour[src_index];
+                    m_data.lumen[dst_index] = m_data.lumen[src_index];
+                    m_data.radius[dst_index] = m_data.radius[src_index];
+                }));
         }
 
         uint PointlightComponentManager::getComponentCount() const
@@ -8,6 +8,7 @@ size_t EngineCore::Common::ProximityTriggerComponentManager::addComponent(Entity
             target,
             trigger_distance,
             false,
+            0,
             enter_callback,
             leave_callback
         }
@@ -22,7 +23,20 @@ size_t EngineCore::Common::ProximityTriggerComponentManager::addComponent(Entity
 
 void EngineCore::Common::ProximityTriggerComponentManager::deleteComponent(Entity entity)
 {
-    //TODO
+    deleteComponents(std::span<Entity const>(&entity, 1));
+}
+
+void EngineCore::Common::ProximityTriggerComponentManager::deleteComponents(std::span<Entity const> entities)
+{
+    for (auto entity : entities)
+    {
+        for (auto index : getIndex(entity)) {
+            data_.deleteComponent(index);
+        }
+    }
+
+    // one new index table for the whole batch
+    removeIndices(entities);
 }
 
 size_t EngineCore::Common::ProximityTriggerComponentManager::getComponentCount() const
@@ -47,3 +61,8 @@ EngineCore::Common::ProximityTriggerComponentManager::Data& EngineCore::Common::
     auto indices = data_.getIndices(index);
     return data_(indices.first, indices.second);
 }
+
+size_t EngineCore::Common::ProximityTriggerComponentManager::getComponentPageCount() const
+{
+    return data_.getUsedPageCount();
+}
@@ -19,6 +19,7 @@ namespace EngineCore
                 Entity                target;           ///< entity for which the proximity is tracked
                 float                 trigger_distance; ///< distance at which the callback will trigger
                 bool                  in_proximity;     ///< flag whether target was in proximity during the last check
+                uint64_t              checked_version;  ///< transform change version at the last check, unmoved transforms are not checked again
                 std::function<void()> enter_callback;   ///< function that is called when the target enters proximity
                 std::function<void()> leave_callback;   ///< function that is called when the target leaves proximity
             };
@@ -33,6 +34,8 @@ namespace EngineCore
 
             void deleteComponent(Entity entity);
 
+            void deleteComponents(std::span<Entity const> entities) override;
+
             size_t getComponentCount() const;
 
             bool checkComponent(size_t index);
@@ -40,6 +43,19 @@ namespace EngineCore
             Data const& getComponent(size_t index) const;
 
             Data& getComponent(size_t index);
+
+            /** Number of component pages, i.e. the page range for forEachComponent */
+            size_t getComponentPageCount() const;
+
+            /**
+             * Call fn(index, component) for every live component in the pages [page_begin, page_end).
+             * Disjoint page ranges can be processed concurrently.
+             */
+            template<typename Function>
+            void forEachComponent(size_t page_begin, size_t page_end, Function&& fn)
+            {
+                data_.forEachPage(page_begin, page_end, std::forward<Function>(fn));
+            }
         };
 
     }
@@ -0,0 +1,191 @@
+#ifndef Query_hpp
+#define Query_hpp
+
+#include <algorithm>
+#include <array>
+#include <limits>
+#include <span>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "BaseMultiInstanceComponentManager.hpp"
+#include "BaseSingleInstanceComponentManager.hpp"
+#include "EntityManager.hpp"
+#include "TaskScheduler.hpp"
+
+namespace EngineCore
+{
+    /**
+     * View of all entities that have components in each of the given component managers,
+     * e.g. world_state.query<TransformComponentManager, MaterialComponentManager>().
+     * Iteration is driven by the manager with the fewest entities. The driving entities are processed in chunks,
+     * with one batched index lookup per manager and chunk before the callback runs for the matches of the chunk.
+     * The callback gets the entity and its component index per manager, i.e. a size_t for single instance
+     * managers and an IndexRange for multi instance managers, in the order of the manager types.
+     * The set of driving entities is taken when iteration starts.
+     */
+    template <typename... ComponentManagerTypes>
+    class Query
+    {
+    public:
+        /** Number of entities looked up together */
+        static constexpr size_t chunk_size = 256;
+
+        explicit Query(ComponentManagerTypes const&... component_mngrs);
+
+        /**
+         * Call fn(entity, indices...) for every matching entity.
+         */
+        template <typename Function>
+        void forEach(Function&& fn) const;
+
+        /**
+         * Call fn(entity, indices...) for every matching entity, with chunks processed in parallel on the task scheduler.
+         * fn has to be safe to call concurrently for different entities.
+         * \param grain_size Number of driving entities per task. If 0, chosen by TaskScheduler::parallelFor.
+         */
+        template <typename Function>
+        void forEach(Utility::TaskScheduler& task_scheduler, Function&& fn, size_t grain_size = 0) const;
+
+        /**
+         * Upper bound for the number of matching entities, i.e. the entity count of the driving manager.
+         */
+        size_t getSizeEstimate() const;
+
+    private:
+        template <typename ComponentManagerType>
+        using IndexType = decltype(std::declval<ComponentManagerType const&>().getIndex(0u));
+
+        static bool isValid(size_t index) { return index != Utility::SingleInstanceIndexMap::invalid_index; }
+        static bool isValid(Utility::MultiInstanceIndexMap::IndexRange const& range) { return !range.empty(); }
+
+        /** Position of the manager with the fewest entities in component_mngrs_ */
+        size_t getDriverIndex() const;
+
+        std::vector<unsigned int> getDriverEntityIds() const;
+
+        template <typename Function>
+        void processChunks(std::span<unsigned int const> entity_ids, Function& fn) const;
+
+        template <typename Function, size_t... Is>
+        void processChunk(std::span<unsigned int const> entity_ids, Function& fn, std::index_sequence<Is...>) const;
+
+        std::tuple<ComponentManagerTypes const&...> component_mngrs_;
+    };
+
+    template <typename... ComponentManagerTypes>
+    inline Query<ComponentManagerTypes...>::Query(ComponentManagerTypes const&... component_mngrs)
+        : component_mngrs_(component_mngrs...)
+    {
+        static_assert(sizeof...(ComponentManagerTypes) > 0, "A query needs at least one component manager");
+    }
+
+    template <typename... ComponentManagerTypes>
+    template <typename Function>
+    inline void Query<ComponentManagerTypes...>::forEach(Function&& fn) const
+    {
+        std::vector<unsigned int> entity_ids = getDriverEntityIds();
+
+        processChunks(entity_ids, fn);
+    }
+
+    template <typename... ComponentManagerTypes>
+    template <typename Function>
+    inline void Query<ComponentManagerTypes...>::forEach(Utility::TaskScheduler& task_scheduler, Function&& fn, size_t grain_size) const
+    {
+        std::vector<unsigned int> entity_ids = getDriverEntityIds();
+
+        task_scheduler.parallelFor(0, entity_ids.size(),
+            [this, &entity_ids, &fn](size_t from, size_t to) {
+                processChunks(std::span<unsigned int const>(entity_ids.data() + from, to - from), fn);
+            },
+            grain_size
+        );
+    }
+
+    template <typename... ComponentManagerTypes>
+    inline size_t Query<ComponentManagerTypes...>::getSizeEstimate() const
+    {
+        return std::apply([](auto const&... component_mngrs) {
+            return std::min({ component_mngrs.getEntityCount()... });
+        }, component_mngrs_);
+    }
+
+    template <typename... ComponentManagerTypes>
+    inline size_t Query<ComponentManagerTypes...>::getDriverIndex() const
+    {
+        size_t driver_idx = 0;
+        size_t min_entity_cnt = (std::numeric_limits<size_t>::max)();
+
+        std::apply([&driver_idx, &min_entity_cnt](auto const&... component_mngrs) {
+            size_t i = 0;
+            auto visit = [&](auto const& component_mngr) {
+                size_t entity_cnt = component_mngr.getEntityCount();
+                if (entity_cnt < min_entity_cnt)
+                {
+                    min_entity_cnt = entity_cnt;
+                    driver_idx = i;
+                }
+                ++i;
+            };
+            (visit(component_mngrs), ...);
+        }, component_mngrs_);
+
+        return driver_idx;
+    }
+
+    template <typename... ComponentManagerTypes>
+    inline std::vector<unsigned int> Query<ComponentManagerTypes...>::getDriverEntityIds() const
+    {
+        std::vector<unsigned int> entity_ids;
+
+        size_t driver_idx = getDriverIndex();
+
+        std::apply([driver_idx, &entity_ids](auto const&... component_mngrs) {
+            size_t i = 0;
+            auto visit = [&](auto const& component_mngr) {
+                if (i++ == driver_idx) {
+                    component_mngr.getEntityIds(entity_ids);
+                }
+            };
+            (visit(component_mngrs), ...);
+        }, component_mngrs_);
+
+        return entity_ids;
+    }
+
+    template <typename... ComponentManagerTypes>
+    template <typename Function>
+    inline void Query<ComponentManagerTypes...>::processChunks(std::span<unsigned int const> entity_ids, Function& fn) const
+    {
+        for (size_t chunk_begin = 0; chunk_begin < entity_ids.size(); chunk_begin += chunk_size)
+        {
+            processChunk(entity_ids.subspan(chunk_begin, (std::min)(chunk_size, entity_ids.size() - chunk_begin)), fn,
+                std::index_sequence_for<ComponentManagerTypes...>());
+        }
+    }
+
+    template <typename... ComponentManagerTypes>
+    template <typename Function, size_t... Is>
+    inline void Query<ComponentManagerTypes...>::processChunk(std::span<unsigned int const> entity_ids, Function& fn, std::index_sequence<Is...>) const
+    {
+        // component indices of the chunk per manager, looked up manager by manager to stay within one index map at a time
+        std::tuple<std::array<IndexType<ComponentManagerTypes>, chunk_size>...> indices;
+
+        (std::get<Is>(component_mngrs_).getIndices(entity_ids, std::span(std::get<Is>(indices))), ...);
+
+        for (size_t i = 0; i < entity_ids.size(); ++i)
+        {
+            if ((isValid(std::get<Is>(indices)[i]) && ...))
+            {
+                Entity entity;
+                entity.m_id = entity_ids[i];
+
+                fn(entity, std::get<Is>(indices)[i]...);
+            }
+        }
+    }
+}
+
+#endif // !Query_hpp
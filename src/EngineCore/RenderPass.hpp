@@ -99,6 +99,7 @@ namespace EngineCore
             RenderPass& operator=(RenderPass const& rhs)
             {
                 delete m_pass;
+                m_description = rhs.m_description;
                 m_pass = rhs.m_pass->clone();
 
                 return *this;
@@ -112,6 +113,8 @@ namespace EngineCore
 
             void execute() { m_pass->execute(); }
 
+            std::string const& getDescription() const { return m_description; }
+
         private:
             std::string    m_description;
 
@@ -6,11 +6,15 @@
 #ifndef RenderTaskComponentManager_hpp
 #define RenderTaskComponentManager_hpp
 
+#include <algorithm>
 #include <set>
+#include <span>
+#include <vector>
 
 #include "EntityManager.hpp"
 #include "BaseMultiInstanceComponentManager.hpp"
 #include "BaseResourceManager.hpp"
+#include "SnapshotVector.hpp"
 
 namespace EngineCore
 {
@@ -96,18 +100,32 @@ namespace EngineCore
                 size_t cached_material_idx,
                 bool visible = true);
 
+            /**
+             * Add several render tasks at once, e.g. all primitives of an imported scene.
+             * The batch is sorted and merged into the sorted task list in a single pass.
+             */
+            void addComponents(std::span<Data const> components);
+
+            void deleteComponent(Entity entity);
+
+            /**
+             * Remove all render tasks of the given entities. The remaining tasks stay sorted.
+             */
+            void deleteComponents(std::span<Entity const> entities) override;
+
             void setVisibility(Entity entity, bool visible);
 
             void setVisibility(size_t index, bool visible);
 
-            std::vector<Data> & getComponentData(); //TODO this is not thread safe, is it?
-
-            std::vector<Data> getComponentDataCopy() const;
+            /**
+             * Immutable snapshot of all render tasks, sorted by shader and mesh. Taking it does not copy
+             * the tasks unless they changed since the last snapshot, so passes can take one every frame.
+             */
+            typename Utility::SnapshotVector<Data>::Snapshot getComponentDataSnapshot() const;
 
         private:
 
-            std::vector<Data>         m_data; //< store render task sorted by shader and mesh ResourceIDs
-            mutable std::shared_mutex m_data_mutex;
+            Utility::SnapshotVector<Data> m_data; //< store render task sorted by shader and mesh ResourceIDs
         };
 
 
@@ -123,11 +141,7 @@ namespace EngineCore
             size_t cached_material_idx,
             bool visible)
         {
-            std::unique_lock<std::shared_mutex> lock(m_data_mutex);
-
-            addIndex(entity.id(), m_data.size());
-
-            m_data.emplace_back(Data(
+            Data component(
                 entity,
                 mesh,
                 mesh_component_subidx,
@@ -136,53 +150,136 @@ namespace EngineCore
                 visible,
                 cached_transform_idx,
                 cached_mesh_idx,
-                cached_material_idx)
-            );
-
-            std::sort(m_data.begin(), m_data.end());
+                cached_material_idx);
 
-            rebuildIndexMap(m_data);
+            addComponents(std::span<Data const>(&component, 1));
         }
 
         template<typename TagType>
-        inline void RenderTaskComponentManager<TagType>::setVisibility(Entity entity, bool visible)
+        inline void RenderTaskComponentManager<TagType>::addComponents(std::span<Data const> components)
         {
-            auto index_query = getIndex(entity.id());
+            if (components.empty()) {
+                return;
+            }
 
-            std::unique_lock<std::shared_mutex> lock(m_data_mutex);
+            std::vector<Data> added(components.begin(), components.end());
+            std::stable_sort(added.begin(), added.end());
+
+            m_data.modify([this, &added](std::vector<Data>& tasks) {
+                std::vector<Data> data;
+                data.reserve(tasks.size() + added.size());
+
+                std::vector<size_t>       new_indices(tasks.size());
+                std::vector<unsigned int> added_entity_ids;
+                std::vector<size_t>       added_indices;
+                added_entity_ids.reserve(added.size());
+                added_indices.reserve(added.size());
+
+                // merge both sorted lists, existing tasks come first among equal ones
+                size_t old_i = 0;
+                size_t added_i = 0;
+
+                while (old_i < tasks.size() || added_i < added.size())
+                {
+                    if (added_i == added.size() || (old_i < tasks.size() && !(added[added_i] < tasks[old_i])))
+                    {
+                        new_indices[old_i] = data.size();
+                        data.push_back(std::move(tasks[old_i]));
+                        ++old_i;
+                    }
+                    else
+                    {
+                        added_entity_ids.push_back(added[added_i].entity.id());
+                        added_indices.push_back(data.size());
+                        data.push_back(std::move(added[added_i]));
+                        ++added_i;
+                    }
+                }
 
-            for (auto index : index_query)
-            {
-                m_data[index].visible = visible;
-            }
+                tasks.swap(data);
+
+                // existing entries only move, so the index map is updated without rebuilding it
+                remapIndices(new_indices);
+                addIndices(added_entity_ids, added_indices);
+            });
         }
 
         template<typename TagType>
-        inline void RenderTaskComponentManager<TagType>::setVisibility(size_t index, bool visible)
+        inline void RenderTaskComponentManager<TagType>::deleteComponent(Entity entity)
         {
-            std::unique_lock<std::shared_mutex> lock(m_data_mutex);
-
-            m_data[index].visible = visible;
+            deleteComponents(std::span<Entity const>(&entity, 1));
         }
 
         template<typename TagType>
-        inline std::vector<typename RenderTaskComponentManager<TagType>::Data>& RenderTaskComponentManager<TagType>::getComponentData()
+        inline void RenderTaskComponentManager<TagType>::deleteComponents(std::span<Entity const> entities)
         {
-            return m_data;
+            if (entities.empty()) {
+                return;
+            }
+
+            std::vector<unsigned int> removed_ids;
+            removed_ids.reserve(entities.size());
+            for (auto entity : entities) {
+                removed_ids.push_back(entity.id());
+            }
+            std::sort(removed_ids.begin(), removed_ids.end());
+
+            m_data.modify([this, &removed_ids](std::vector<Data>& tasks) {
+                std::vector<size_t> new_indices(tasks.size());
+                size_t cnt = 0;
+
+                // compact in place, which keeps the remaining tasks sorted
+                for (size_t idx = 0; idx < tasks.size(); ++idx)
+                {
+                    if (std::binary_search(removed_ids.begin(), removed_ids.end(), tasks[idx].entity.id()))
+                    {
+                        new_indices[idx] = Utility::MultiInstanceIndexMap::invalid_index;
+                        continue;
+                    }
+
+                    new_indices[idx] = cnt;
+                    if (cnt != idx) {
+                        tasks[cnt] = std::move(tasks[idx]);
+                    }
+                    ++cnt;
+                }
+
+                if (cnt == tasks.size()) {
+                    return;
+                }
+
+                tasks.erase(tasks.begin() + cnt, tasks.end());
+
+                remapIndices(new_indices);
+            });
         }
 
         template<typename TagType>
-        inline std::vector<typename RenderTaskComponentManager<TagType>::Data> RenderTaskComponentManager<TagType>::getComponentDataCopy() const
+        inline void RenderTaskComponentManager<TagType>::setVisibility(Entity entity, bool visible)
         {
-            std::vector<EngineCore::Graphics::RenderTaskComponentManager<TagType>::Data> retval;
+            m_data.modify([this, entity, visible](std::vector<Data>& tasks) {
+                // look up under the lock, adding or removing tasks moves the indices
+                auto index_query = getIndex(entity.id());
 
-            {
-                std::shared_lock<std::shared_mutex> lock(m_data_mutex);
+                for (auto index : index_query)
+                {
+                    tasks[index].visible = visible;
+                }
+            });
+        }
 
-                retval = m_data;
-            }
+        template<typename TagType>
+        inline void RenderTaskComponentManager<TagType>::setVisibility(size_t index, bool visible)
+        {
+            m_data.modify([index, visible](std::vector<Data>& tasks) {
+                tasks[index].visible = visible;
+            });
+        }
 
-            return retval;
+        template<typename TagType>
+        inline typename Utility::SnapshotVector<typename RenderTaskComponentManager<TagType>::Data>::Snapshot RenderTaskComponentManager<TagType>::getComponentDataSnapshot() const
+        {
+            return m_data.getSnapshot();
         }
 
 
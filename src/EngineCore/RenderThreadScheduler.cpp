@@ -0,0 +1,78 @@
+#include "RenderThreadScheduler.hpp"
+
+namespace EngineCore
+{
+    namespace Utility
+    {
+
+        RenderThreadScheduler::RenderThreadScheduler(std::function<Clock::time_point()> clock)
+            : pending_tasks_cnt_(0), clock_(std::move(clock))
+        {
+        }
+
+        void RenderThreadScheduler::submit(std::function<void()> task, Priority priority)
+        {
+            pending_tasks_cnt_.fetch_add(1, std::memory_order_relaxed);
+            submitted_tasks_[static_cast<size_t>(priority)].push(std::move(task));
+        }
+
+        size_t RenderThreadScheduler::process(std::chrono::duration<double, std::milli> budget)
+        {
+            auto start_time = clock_();
+
+            // take a snapshot of all submitted tasks, appended after the tasks carried over from previous frames
+            for (size_t priority = 0; priority < priority_cnt_; ++priority)
+            {
+                submitted_tasks_[priority].drain(batch_);
+
+                for (auto& task : batch_) {
+                    carried_over_tasks_[priority].push_back(std::move(task));
+                }
+
+                batch_.clear();
+            }
+
+            size_t executed_cnt = 0;
+
+            auto& critical_tasks = carried_over_tasks_[static_cast<size_t>(Priority::CRITICAL)];
+            while (!critical_tasks.empty())
+            {
+                std::function<void()> task = std::move(critical_tasks.front());
+                critical_tasks.pop_front();
+                task();
+                ++executed_cnt;
+            }
+
+            for (Priority priority : { Priority::STREAMING, Priority::BACKGROUND })
+            {
+                auto& tasks = carried_over_tasks_[static_cast<size_t>(priority)];
+
+                // the first task of each class runs regardless of the budget, so no class is starved by the ones before it
+                bool any_executed = false;
+
+                while (!tasks.empty())
+                {
+                    if (any_executed && (clock_() - start_time) >= budget) {
+                        break;
+                    }
+
+                    std::function<void()> task = std::move(tasks.front());
+                    tasks.pop_front();
+                    task();
+                    ++executed_cnt;
+                    any_executed = true;
+                }
+            }
+
+            pending_tasks_cnt_.fetch_sub(executed_cnt, std::memory_order_relaxed);
+
+            return executed_cnt;
+        }
+
+        size_t RenderThreadScheduler::getPendingTaskCount() const
+        {
+            return pending_tasks_cnt_.load(std::memory_order_relaxed);
+        }
+
+    }
+}
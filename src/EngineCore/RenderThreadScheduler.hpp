@@ -0,0 +1,85 @@
+#ifndef RenderThreadScheduler_hpp
+#define RenderThreadScheduler_hpp
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <functional>
+#include <vector>
+
+#include "MPMCQueue.hpp"
+
+namespace EngineCore
+{
+    namespace Utility
+    {
+
+        /**
+         * Schedules tasks that have to be executed on the render thread (e.g. GPU uploads) across frames.
+         * Tasks can be submitted from any thread. The render thread calls process once per frame,
+         * which executes tasks in order of priority until the given time budget is used up.
+         * Tasks that did not fit into the budget are carried over to the next frame.
+         * Within a priority class, tasks are executed in submission order.
+         * Has no dependency on a graphics API, i.e. tasks can be anything callable.
+         */
+        class RenderThreadScheduler
+        {
+        public:
+            enum class Priority
+            {
+                CRITICAL,  ///< required for the current frame, e.g. resource manager tasks, always executed regardless of the budget
+                STREAMING, ///< e.g. asset uploads and landscape updates, executed within the budget
+                BACKGROUND ///< executed with budget left over from critical and streaming tasks, at least one per frame
+            };
+
+            typedef std::chrono::steady_clock Clock;
+
+            /**
+             * \param clock Time source for budget accounting, replaceable for testing
+             */
+            explicit RenderThreadScheduler(std::function<Clock::time_point()> clock = &Clock::now);
+            ~RenderThreadScheduler() = default;
+
+            RenderThreadScheduler(RenderThreadScheduler const& cpy) = delete;
+            RenderThreadScheduler& operator=(RenderThreadScheduler const& rhs) = delete;
+
+            /**
+             * Submit a task for execution on the render thread. Thread-safe.
+             */
+            void submit(std::function<void()> task, Priority priority = Priority::STREAMING);
+
+            /**
+             * Execute pending tasks. Only to be called from the render thread.
+             * All critical tasks are executed. Then streaming and background tasks are executed until the
+             * budget is exceeded, but at least one task of each class per call so that neither can be starved
+             * by the classes of higher priority.
+             * Tasks submitted during the call, e.g. by executed tasks, are left for the next call.
+             * \return Returns the number of executed tasks
+             */
+            size_t process(std::chrono::duration<double, std::milli> budget);
+
+            /** Number of submitted tasks that have not been executed yet */
+            size_t getPendingTaskCount() const;
+
+        private:
+            static constexpr size_t priority_cnt_ = 3;
+
+            /** Newly submitted tasks per priority */
+            std::array<MPMCQueue<std::function<void()>>, priority_cnt_> submitted_tasks_;
+
+            /** Tasks taken from the submission queues but not yet executed, only accessed by the render thread */
+            std::array<std::deque<std::function<void()>>, priority_cnt_> carried_over_tasks_;
+
+            /** Storage for draining the submission queues, kept as member to reuse its storage */
+            std::vector<std::function<void()>> batch_;
+
+            std::atomic<size_t> pending_tasks_cnt_;
+
+            std::function<Clock::time_point()> clock_;
+        };
+
+    }
+}
+
+#endif // !RenderThreadScheduler_hpp
@@ -0,0 +1,190 @@
+#include "SchedulerTelemetry.hpp"
+
+#include <algorithm>
+#include <fstream>
+
+void EngineCore::Utility::SchedulerTelemetry::WorkerBuffer::record(Event const& event)
+{
+    Slot* slots = slots_.load(std::memory_order_relaxed);
+
+    if (slots == nullptr)
+    {
+        slots = new Slot[capacity];
+        slots_.store(slots, std::memory_order_release);
+    }
+
+    uint64_t idx = write_idx_.load(std::memory_order_relaxed);
+    Slot& slot = slots[idx % capacity];
+
+    slot.sequence.store(2 * idx + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    slot.type.store(static_cast<uint32_t>(event.type), std::memory_order_relaxed);
+    slot.begin_ns.store(event.begin_ns, std::memory_order_relaxed);
+    slot.end_ns.store(event.end_ns, std::memory_order_relaxed);
+    slot.queue_depth.store(event.queue_depth, std::memory_order_relaxed);
+
+    slot.sequence.store(2 * idx + 2, std::memory_order_release);
+    write_idx_.store(idx + 1, std::memory_order_release);
+
+    // single writer, so the counters don't need read-modify-write operations
+    uint64_t duration = event.end_ns - event.begin_ns;
+
+    if (event.type == EventType::TASK)
+    {
+        executed_task_cnt_.store(executed_task_cnt_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        busy_ns_.store(busy_ns_.load(std::memory_order_relaxed) + duration, std::memory_order_relaxed);
+
+        if (event.queue_depth > max_queue_depth_.load(std::memory_order_relaxed)) {
+            max_queue_depth_.store(event.queue_depth, std::memory_order_relaxed);
+        }
+    }
+    else
+    {
+        idle_ns_.store(idle_ns_.load(std::memory_order_relaxed) + duration, std::memory_order_relaxed);
+    }
+}
+
+void EngineCore::Utility::SchedulerTelemetry::WorkerBuffer::recordSteal()
+{
+    steal_cnt_.store(steal_cnt_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+}
+
+void EngineCore::Utility::SchedulerTelemetry::WorkerBuffer::getEvents(std::vector<Event>& events) const
+{
+    Slot const* slots = slots_.load(std::memory_order_acquire);
+
+    if (slots == nullptr) {
+        return;
+    }
+
+    uint64_t end = write_idx_.load(std::memory_order_acquire);
+    uint64_t begin = (end > capacity) ? end - capacity : 0;
+
+    for (uint64_t idx = begin; idx < end; ++idx)
+    {
+        Slot const& slot = slots[idx % capacity];
+
+        uint64_t sequence = slot.sequence.load(std::memory_order_acquire);
+
+        // skip slots that are being overwritten with newer events
+        if (sequence != 2 * idx + 2) {
+            continue;
+        }
+
+        Event event;
+        event.type = static_cast<EventType>(slot.type.load(std::memory_order_relaxed));
+        event.begin_ns = slot.begin_ns.load(std::memory_order_relaxed);
+        event.end_ns = slot.end_ns.load(std::memory_order_relaxed);
+        event.queue_depth = slot.queue_depth.load(std::memory_order_relaxed);
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+
+        if (slot.sequence.load(std::memory_order_relaxed) == sequence) {
+            events.push_back(event);
+        }
+    }
+}
+
+EngineCore::Utility::SchedulerTelemetry::WorkerStatistics EngineCore::Utility::SchedulerTelemetry::WorkerBuffer::getStatistics() const
+{
+    WorkerStatistics retval;
+    retval.executed_task_cnt = executed_task_cnt_.load(std::memory_order_relaxed);
+    retval.steal_cnt = steal_cnt_.load(std::memory_order_relaxed);
+    retval.max_queue_depth = max_queue_depth_.load(std::memory_order_relaxed);
+    retval.busy_ms = static_cast<double>(busy_ns_.load(std::memory_order_relaxed)) / 1.0e6;
+    retval.idle_ms = static_cast<double>(idle_ns_.load(std::memory_order_relaxed)) / 1.0e6;
+    return retval;
+}
+
+EngineCore::Utility::SchedulerTelemetry::SchedulerTelemetry()
+    : enabled_(false), epoch_(std::chrono::steady_clock::now())
+{
+}
+
+uint64_t EngineCore::Utility::SchedulerTelemetry::now() const
+{
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - epoch_).count());
+}
+
+std::vector<EngineCore::Utility::SchedulerTelemetry::WorkerStatistics> EngineCore::Utility::SchedulerTelemetry::getWorkerStatistics() const
+{
+    std::vector<WorkerStatistics> retval;
+    retval.reserve(worker_buffers_.size());
+
+    for (auto const& buffer : worker_buffers_) {
+        retval.push_back(buffer->getStatistics());
+    }
+
+    return retval;
+}
+
+void EngineCore::Utility::SchedulerTelemetry::writeChromeTrace(std::ostream& stream) const
+{
+    stream << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+
+    bool first = true;
+    auto separator = [&stream, &first]() -> std::ostream& {
+        if (!first) {
+            stream << ",";
+        }
+        first = false;
+        return stream;
+    };
+
+    std::vector<Event> events;
+
+    for (size_t worker_idx = 0; worker_idx < worker_buffers_.size(); ++worker_idx)
+    {
+        separator() << "\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":" << worker_idx
+            << ",\"args\":{\"name\":\"Worker " << worker_idx << "\"}}";
+
+        events.clear();
+        worker_buffers_[worker_idx]->getEvents(events);
+
+        for (auto const& event : events)
+        {
+            // trace timestamps are in microseconds
+            double ts = static_cast<double>(event.begin_ns) / 1000.0;
+            double dur = static_cast<double>(event.end_ns - event.begin_ns) / 1000.0;
+
+            bool is_task = (event.type == EventType::TASK);
+
+            separator() << "\n{\"name\":\"" << (is_task ? "task" : "idle") << "\",\"cat\":\"" << (is_task ? "task" : "idle")
+                << "\",\"ph\":\"X\",\"pid\":0,\"tid\":" << worker_idx << ",\"ts\":" << ts << ",\"dur\":" << dur << "}";
+
+            if (is_task)
+            {
+                separator() << "\n{\"name\":\"Queue depth worker " << worker_idx << "\",\"ph\":\"C\",\"pid\":0,\"tid\":" << worker_idx
+                    << ",\"ts\":" << ts << ",\"args\":{\"tasks\":" << event.queue_depth << "}}";
+            }
+        }
+    }
+
+    stream << "\n]}\n";
+}
+
+bool EngineCore::Utility::SchedulerTelemetry::dumpChromeTrace(std::string const& filepath) const
+{
+    std::ofstream file(filepath);
+
+    if (!file.is_open()) {
+        return false;
+    }
+
+    file.precision(3);
+    file << std::fixed;
+    writeChromeTrace(file);
+
+    return true;
+}
+
+void EngineCore::Utility::SchedulerTelemetry::reset(int worker_cnt)
+{
+    epoch_ = std::chrono::steady_clock::now();
+
+    worker_buffers_.clear();
+    for (int i = 0; i < worker_cnt; ++i) {
+        worker_buffers_.push_back(std::make_unique<WorkerBuffer>());
+    }
+}
@@ -0,0 +1,136 @@
+#ifndef SchedulerTelemetry_hpp
+#define SchedulerTelemetry_hpp
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace EngineCore
+{
+    namespace Utility
+    {
+
+        /**
+         * Records what the worker threads of a TaskScheduler spend their time on.
+         * Each worker writes to its own lock-free event buffer, so recording does not synchronize workers.
+         * Disabled by default, recording only costs a relaxed load per task while disabled.
+         */
+        class SchedulerTelemetry
+        {
+        public:
+            enum class EventType : uint32_t
+            {
+                TASK, ///< execution of a single task
+                IDLE  ///< time a worker spent without finding a task, spinning or sleeping
+            };
+
+            struct Event
+            {
+                EventType type;
+                uint64_t  begin_ns;
+                uint64_t  end_ns;
+                /** Tasks queued for the worker when the event began */
+                uint64_t  queue_depth;
+            };
+
+            struct WorkerStatistics
+            {
+                uint64_t executed_task_cnt = 0;
+                uint64_t steal_cnt = 0;
+                uint64_t max_queue_depth = 0;
+                double   busy_ms = 0.0;
+                double   idle_ms = 0.0;
+            };
+
+            /**
+             * Single writer event buffer of a worker. Holds the most recent events, older ones are overwritten.
+             */
+            class WorkerBuffer
+            {
+            public:
+                WorkerBuffer() : slots_(nullptr), write_idx_(0), executed_task_cnt_(0), steal_cnt_(0),
+                    max_queue_depth_(0), busy_ns_(0), idle_ns_(0) {}
+                ~WorkerBuffer() { delete[] slots_.load(); }
+
+                /** Only to be called by the owning worker */
+                void record(Event const& event);
+
+                /** Only to be called by the owning worker */
+                void recordSteal();
+
+                /** Copy the currently held events, can be called concurrently to recording */
+                void getEvents(std::vector<Event>& events) const;
+
+                WorkerStatistics getStatistics() const;
+
+            private:
+                static constexpr size_t capacity = 8192;
+
+                /** Seqlock protected event, the sequence is odd while the slot is being written */
+                struct Slot
+                {
+                    std::atomic<uint64_t> sequence{ 0 };
+                    std::atomic<uint32_t> type{ 0 };
+                    std::atomic<uint64_t> begin_ns{ 0 };
+                    std::atomic<uint64_t> end_ns{ 0 };
+                    std::atomic<uint64_t> queue_depth{ 0 };
+                };
+
+                /** Allocated by the owning worker on its first event */
+                std::atomic<Slot*>    slots_;
+                std::atomic<uint64_t> write_idx_;
+
+                std::atomic<uint64_t> executed_task_cnt_;
+                std::atomic<uint64_t> steal_cnt_;
+                std::atomic<uint64_t> max_queue_depth_;
+                std::atomic<uint64_t> busy_ns_;
+                std::atomic<uint64_t> idle_ns_;
+            };
+
+            SchedulerTelemetry();
+
+            SchedulerTelemetry(SchedulerTelemetry const& cpy) = delete;
+            SchedulerTelemetry& operator=(SchedulerTelemetry const& rhs) = delete;
+
+            void setEnabled(bool enabled) { enabled_.store(enabled, std::memory_order_relaxed); }
+
+            bool isEnabled() const { return enabled_.load(std::memory_order_relaxed); }
+
+            /** Nanoseconds since the worker buffers were last reset */
+            uint64_t now() const;
+
+            WorkerBuffer& getWorkerBuffer(int worker_idx) { return *worker_buffers_[worker_idx]; }
+
+            std::vector<WorkerStatistics> getWorkerStatistics() const;
+
+            /**
+             * Write all recorded events in the Chrome trace event format (chrome://tracing, Perfetto),
+             * with one track per worker plus its queue depth.
+             */
+            void writeChromeTrace(std::ostream& stream) const;
+
+            /**
+             * Write Chrome trace to file.
+             * \return Returns false if the file could not be opened
+             */
+            bool dumpChromeTrace(std::string const& filepath) const;
+
+        private:
+            friend class TaskScheduler;
+
+            /** Discard all events and statistics and set up buffers for the given number of workers. Not thread-safe. */
+            void reset(int worker_cnt);
+
+            std::atomic<bool>                          enabled_;
+            std::chrono::steady_clock::time_point      epoch_;
+            std::vector<std::unique_ptr<WorkerBuffer>> worker_buffers_;
+        };
+
+    }
+}
+
+#endif // !SchedulerTelemetry_hpp
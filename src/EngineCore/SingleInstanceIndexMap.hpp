@@ -2,94 +2,291 @@
 #define SingleInstanceIndexMap_hpp
 
 #include <atomic>
-#include <list>
+#include <cassert>
+#include <cstdint>
+#include <limits>
+#include <memory>
 #include <mutex>
+#include <span>
 #include <vector>
 
 namespace EngineCore {
     namespace Utility {
+
+        /**
+         * Maps entity ids to the index of their (single) component.
+         * Paged sparse array over the entity index (lower 24 bits of the id), pages are only allocated for
+         * index ranges that contain entities with a component. Each entry stores the full entity id next to
+         * the component index, so a lookup only returns an index if the entry was written for exactly that id,
+         * i.e. stale entities of an earlier generation find nothing. Lookups are lock-free, changes are serialized.
+         */
         class SingleInstanceIndexMap
         {
         public:
+            static constexpr size_t invalid_index = (std::numeric_limits<size_t>::max)();
+
             SingleInstanceIndexMap();
-            ~SingleInstanceIndexMap() = default;
+            ~SingleInstanceIndexMap();
+
+            SingleInstanceIndexMap(SingleInstanceIndexMap const& cpy) = delete;
+            SingleInstanceIndexMap& operator=(SingleInstanceIndexMap const& rhs) = delete;
 
             void addIndex(unsigned int entity_id, size_t index);
 
+            /**
+             * Add the entries of several entities at once, entity_ids[i] is mapped to component_indices[i]. Takes the lock once.
+             */
+            void addIndices(std::span<unsigned int const> entity_ids, std::span<size_t const> component_indices);
+
+            /**
+             * Remove the entry of the entity. Pages without entries are unhooked and kept for reuse
+             * until releaseEmptyPages is called.
+             */
+            void removeIndex(unsigned int entity_id);
+
+            /**
+             * \return Returns the index of the entity's component or invalid_index if there is none.
+             */
             size_t getIndex(unsigned int entity_id) const;
 
+            /**
+             * Look up the indices of several entities at once, indices[i] receives the result for entity_ids[i].
+             */
+            void getIndices(std::span<unsigned int const> entity_ids, std::span<size_t> indices) const;
+
+            /**
+             * Number of entities with an entry.
+             */
+            size_t getEntityCount() const;
+
+            /**
+             * Append the ids of all entities with an entry, in order of their entity index.
+             */
+            void getEntityIds(std::vector<unsigned int>& entity_ids) const;
+
+            /**
+             * Free the memory of pages that became empty. Must not be called concurrently to lookups.
+             */
+            void releaseEmptyPages();
+
         private:
-            struct Page {
-                std::unique_ptr<std::vector<std::atomic_size_t>> storage;
-                std::atomic_flag loaded;
+            static constexpr unsigned int index_bits_ = 24;
+            static constexpr unsigned int page_bits_ = 10;
+            static constexpr size_t page_size_ = size_t(1) << page_bits_;
+            static constexpr size_t page_cnt_ = size_t(1) << (index_bits_ - page_bits_);
+
+            /** Entries are the entity id in the upper and the component index in the lower 32 bits */
+            static constexpr uint64_t empty_entry_ = (std::numeric_limits<uint64_t>::max)();
+            static constexpr uint32_t no_index_ = (std::numeric_limits<uint32_t>::max)();
+
+            struct Page
+            {
+                Page();
+
+                std::atomic<uint64_t> entries[page_size_];
+                /** Number of non-empty entries, only accessed by writers */
+                size_t                entry_cnt;
             };
 
-            std::vector<Page> index_map_;
+            /** Write an entry, add_index_mutex_ has to be locked */
+            void insert(unsigned int entity_id, size_t component_index);
+
+            /** Shared by all directory slots without a page, never written to */
+            static Page& getEmptyPage();
 
-            static const size_t page_cnt_{ 10000 };
-            static const size_t page_size_{ 16000 };
+            /** Pages by id range, slots without entries point to the empty page */
+            std::unique_ptr<std::atomic<Page*>[]> directory_;
+
+            /** Pages that became empty, reused before allocating new ones */
+            std::vector<Page*> empty_pages_;
+
+            /** Total number of non-empty entries */
+            std::atomic_size_t entry_cnt_;
 
             std::mutex add_index_mutex_;
         };
 
+        inline SingleInstanceIndexMap::Page::Page()
+            : entry_cnt(0)
+        {
+            for (auto& entry : entries) {
+                entry.store(empty_entry_, std::memory_order_relaxed);
+            }
+        }
+
+        inline SingleInstanceIndexMap::Page& SingleInstanceIndexMap::getEmptyPage()
+        {
+            static Page empty_page;
+            return empty_page;
+        }
+
         inline SingleInstanceIndexMap::SingleInstanceIndexMap()
-            : index_map_(page_cnt_)
+            : directory_(new std::atomic<Page*>[page_cnt_]), entry_cnt_(0)
+        {
+            Page* empty_page = &getEmptyPage();
+
+            for (size_t page_idx = 0; page_idx < page_cnt_; ++page_idx) {
+                directory_[page_idx].store(empty_page, std::memory_order_relaxed);
+            }
+        }
+
+        inline SingleInstanceIndexMap::~SingleInstanceIndexMap()
         {
+            Page* empty_page = &getEmptyPage();
+
             for (size_t page_idx = 0; page_idx < page_cnt_; ++page_idx)
             {
-                index_map_[page_idx].storage = nullptr;
-                index_map_[page_idx].loaded.clear();
+                Page* page = directory_[page_idx].load(std::memory_order_relaxed);
+                if (page != empty_page) {
+                    delete page;
+                }
             }
+
+            releaseEmptyPages();
         }
 
         inline void SingleInstanceIndexMap::addIndex(unsigned int entity_id, size_t component_index)
         {
             std::unique_lock<std::mutex> lock(add_index_mutex_);
 
-            //find correct page
-            auto div = std::div(static_cast<long>(entity_id), static_cast<long>(page_size_));
-            auto page_index = div.quot;
-            auto index_in_page = div.rem;
+            insert(entity_id, component_index);
+        }
 
-            assert(page_index < page_cnt_);
+        inline void SingleInstanceIndexMap::addIndices(std::span<unsigned int const> entity_ids, std::span<size_t const> component_indices)
+        {
+            assert(component_indices.size() >= entity_ids.size());
 
-            if (!(index_map_[page_index].loaded.test()))
-            {
-                //add need new page
-                index_map_[page_index].storage = std::make_unique<std::vector<std::atomic_size_t>>(page_size_);
-                index_map_[page_index].loaded.test_and_set();
+            std::unique_lock<std::mutex> lock(add_index_mutex_);
+
+            for (size_t i = 0; i < entity_ids.size(); ++i) {
+                insert(entity_ids[i], component_indices[i]);
+            }
+        }
 
-                //set init value in new page
-                for (size_t j = 0; j < page_size_; ++j) {
-                    index_map_[page_index].storage->at(j).store((std::numeric_limits<size_t>::max)());
+        inline void SingleInstanceIndexMap::insert(unsigned int entity_id, size_t component_index)
+        {
+            size_t page_index = (entity_id & ((1u << index_bits_) - 1)) >> page_bits_;
+            size_t index_in_page = entity_id & (page_size_ - 1);
+
+            assert(component_index < no_index_);
+
+            Page* page = directory_[page_index].load(std::memory_order_relaxed);
+
+            if (page == &getEmptyPage())
+            {
+                if (!empty_pages_.empty())
+                {
+                    page = empty_pages_.back();
+                    empty_pages_.pop_back();
                 }
+                else
+                {
+                    page = new Page();
+                }
+
+                directory_[page_index].store(page, std::memory_order_release);
+            }
+
+            uint64_t previous = page->entries[index_in_page].exchange(
+                (static_cast<uint64_t>(entity_id) << 32) | static_cast<uint32_t>(component_index), std::memory_order_release);
+
+            if (previous == empty_entry_) {
+                ++page->entry_cnt;
+                entry_cnt_.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+
+        inline void SingleInstanceIndexMap::removeIndex(unsigned int entity_id)
+        {
+            std::unique_lock<std::mutex> lock(add_index_mutex_);
+
+            size_t page_index = (entity_id & ((1u << index_bits_) - 1)) >> page_bits_;
+            size_t index_in_page = entity_id & (page_size_ - 1);
 
-                //flag new page as loaded
-                index_map_[page_index].loaded.test_and_set();
+            Page* page = directory_[page_index].load(std::memory_order_relaxed);
+
+            if (page == &getEmptyPage()) {
+                return;
+            }
+
+            if (page->entries[index_in_page].exchange(empty_entry_, std::memory_order_release) == empty_entry_) {
+                return;
             }
 
-            //store index for entity
-            index_map_[page_index].storage->at(index_in_page).store(component_index);
+            entry_cnt_.fetch_sub(1, std::memory_order_relaxed);
+
+            // readers might still be looking at the page, so it is only unhooked here. Stale reads of
+            // a reused page are harmless, as entries written for other ids fail the id check.
+            if (--page->entry_cnt == 0)
+            {
+                directory_[page_index].store(&getEmptyPage(), std::memory_order_release);
+                empty_pages_.push_back(page);
+            }
         }
-        
+
         inline size_t SingleInstanceIndexMap::getIndex(unsigned int entity_id) const
         {
-            size_t retval = (std::numeric_limits<size_t>::max)();
+            size_t page_index = (entity_id & ((1u << index_bits_) - 1)) >> page_bits_;
+
+            Page const* page = directory_[page_index].load(std::memory_order_acquire);
 
-            //find correct page
-            auto div = std::div(static_cast<long>(entity_id), static_cast<long>(page_size_));
-            auto page_index = div.quot;
-            auto index_in_page = div.rem;
+            uint64_t entry = page->entries[entity_id & (page_size_ - 1)].load(std::memory_order_acquire);
 
-            assert(page_index < page_cnt_);
+            uint32_t index = static_cast<uint32_t>(entry);
+            bool valid = (entry >> 32) == entity_id && index != no_index_;
 
-            if (index_map_[page_index].loaded.test())
+            // select without branching, so batches of lookups don't suffer from mispredictions
+            uint64_t mask = uint64_t(0) - static_cast<uint64_t>(valid);
+            return static_cast<size_t>((index & mask) | (invalid_index & ~mask));
+        }
+
+        inline void SingleInstanceIndexMap::getIndices(std::span<unsigned int const> entity_ids, std::span<size_t> indices) const
+        {
+            assert(indices.size() >= entity_ids.size());
+
+            for (size_t i = 0; i < entity_ids.size(); ++i) {
+                indices[i] = getIndex(entity_ids[i]);
+            }
+        }
+
+        inline size_t SingleInstanceIndexMap::getEntityCount() const
+        {
+            return entry_cnt_.load(std::memory_order_relaxed);
+        }
+
+        inline void SingleInstanceIndexMap::getEntityIds(std::vector<unsigned int>& entity_ids) const
+        {
+            Page const* empty_page = &getEmptyPage();
+
+            entity_ids.reserve(entity_ids.size() + getEntityCount());
+
+            for (size_t page_idx = 0; page_idx < page_cnt_; ++page_idx)
             {
-                //store index for entity
-                retval = index_map_[page_index].storage->at(index_in_page).load();
+                Page const* page = directory_[page_idx].load(std::memory_order_acquire);
+
+                if (page == empty_page) {
+                    continue;
+                }
+
+                for (auto const& entry : page->entries)
+                {
+                    uint64_t value = entry.load(std::memory_order_acquire);
+
+                    if (value != empty_entry_) {
+                        entity_ids.push_back(static_cast<unsigned int>(value >> 32));
+                    }
+                }
             }
+        }
 
-            return retval;
+        inline void SingleInstanceIndexMap::releaseEmptyPages()
+        {
+            std::unique_lock<std::mutex> lock(add_index_mutex_);
+
+            for (auto page : empty_pages_) {
+                delete page;
+            }
+            empty_pages_.clear();
         }
     }
 }
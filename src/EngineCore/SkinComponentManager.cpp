@@ -11,6 +11,13 @@ void EngineCore::Animation::SkinComponentManager::addComponent(Entity entity, st
     m_data.push_back(Data(entity, joints, inverse_bind_matrices));
 }
 
+void EngineCore::Animation::SkinComponentManager::deleteComponents(std::span<Entity const> entities)
+{
+    std::unique_lock<std::shared_mutex> lock(m_data_access_mutex);
+
+    eraseComponents(entities, m_data);
+}
+
 std::vector<Entity> const& EngineCore::Animation::SkinComponentManager::getJoints(Entity entity)
 {
     std::shared_lock<std::shared_mutex> lock(m_data_access_mutex);
@@ -39,6 +39,8 @@ namespace EngineCore {
 
             void addComponent(Entity entity, std::vector<Entity> const& joints, std::vector<Mat4x4> const& inverse_bind_matrices);
 
+            void deleteComponents(std::span<Entity const> entities) override;
+
             std::vector<Entity> const& getJoints(Entity entity);
 
             std::vector<Entity> const& getJoints(size_t component_idx);
@@ -0,0 +1,118 @@
+#ifndef SnapshotVector_hpp
+#define SnapshotVector_hpp
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <vector>
+
+namespace EngineCore {
+    namespace Utility {
+
+        /**
+         * Vector of component data with versioned, immutable snapshots for readers, e.g. render passes that
+         * iterate all components every frame. Writers modify the data under a lock. The first snapshot taken
+         * after a change publishes a copy, all further snapshots until the next change share it, so reading
+         * unchanged data costs an atomic load instead of a copy. A snapshot stays valid while it is held,
+         * but does not reflect later changes.
+         */
+        template<typename T>
+        class SnapshotVector
+        {
+        public:
+            typedef std::shared_ptr<std::vector<T> const> Snapshot;
+
+            SnapshotVector() : snapshot_(std::make_shared<std::vector<T> const>()), version_(0), published_version_(0) {}
+            ~SnapshotVector() = default;
+
+            SnapshotVector(SnapshotVector const& cpy) = delete;
+            SnapshotVector& operator=(SnapshotVector const& rhs) = delete;
+
+            /**
+             * Call fn(std::vector<T>&) with exclusive access to the data and return its result.
+             * Changes become visible with the next snapshot.
+             */
+            template<typename Function>
+            decltype(auto) modify(Function&& fn);
+
+            /**
+             * Call fn(std::vector<T> const&) with shared access to the latest data, including changes that are not published yet.
+             */
+            template<typename Function>
+            decltype(auto) read(Function&& fn) const;
+
+            /**
+             * Get the snapshot of the latest data. Only copies the data if it changed since the last snapshot.
+             */
+            Snapshot getSnapshot() const;
+
+            /**
+             * Number of modifications so far, e.g. for readers that cache data derived from a snapshot.
+             */
+            uint64_t getVersion() const;
+
+        private:
+            std::vector<T>                      data_;
+            mutable std::shared_mutex           data_mutex_;
+
+            mutable std::atomic<Snapshot>       snapshot_;
+            std::atomic<uint64_t>               version_;
+            /** Version of the data in snapshot_ */
+            mutable std::atomic<uint64_t>       published_version_;
+            mutable std::mutex                  publish_mutex_;
+        };
+
+        template<typename T>
+        template<typename Function>
+        inline decltype(auto) SnapshotVector<T>::modify(Function&& fn)
+        {
+            std::unique_lock<std::shared_mutex> lock(data_mutex_);
+
+            // the version is advanced before the change, so a snapshot is never stamped with a version it misses
+            version_.fetch_add(1, std::memory_order_release);
+
+            return fn(data_);
+        }
+
+        template<typename T>
+        template<typename Function>
+        inline decltype(auto) SnapshotVector<T>::read(Function&& fn) const
+        {
+            std::shared_lock<std::shared_mutex> lock(data_mutex_);
+
+            return fn(static_cast<std::vector<T> const&>(data_));
+        }
+
+        template<typename T>
+        inline typename SnapshotVector<T>::Snapshot SnapshotVector<T>::getSnapshot() const
+        {
+            if (published_version_.load(std::memory_order_acquire) != version_.load(std::memory_order_acquire))
+            {
+                // writers are blocked while the copy is made, concurrent readers publish only once
+                std::shared_lock<std::shared_mutex> lock(data_mutex_);
+                std::unique_lock<std::mutex> publish_lock(publish_mutex_);
+
+                uint64_t version = version_.load(std::memory_order_acquire);
+
+                if (published_version_.load(std::memory_order_relaxed) != version)
+                {
+                    snapshot_.store(std::make_shared<std::vector<T> const>(data_), std::memory_order_release);
+                    published_version_.store(version, std::memory_order_release);
+                }
+            }
+
+            return snapshot_.load(std::memory_order_acquire);
+        }
+
+        template<typename T>
+        inline uint64_t SnapshotVector<T>::getVersion() const
+        {
+            return version_.load(std::memory_order_acquire);
+        }
+
+    }
+}
+
+#endif // !SnapshotVector_hpp
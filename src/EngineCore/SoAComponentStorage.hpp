@@ -0,0 +1,224 @@
+#ifndef SoAComponentStorage_hpp
+#define SoAComponentStorage_hpp
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <span>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "ComponentPages.hpp"
+
+namespace EngineCore {
+    namespace Utility {
+
+        namespace detail
+        {
+            /**
+             * Fixed size array starting at a cache line boundary (or the type's alignment, if larger).
+             */
+            template<typename F, size_t Size>
+            class AlignedArray
+            {
+            public:
+                static constexpr size_t alignment = std::max(alignof(F), size_t(64));
+
+                AlignedArray()
+                    : data_(static_cast<F*>(::operator new(sizeof(F) * Size, std::align_val_t(alignment))))
+                {
+                    std::uninitialized_value_construct_n(data_, Size);
+                }
+
+                ~AlignedArray()
+                {
+                    std::destroy_n(data_, Size);
+                    ::operator delete(data_, std::align_val_t(alignment));
+                }
+
+                AlignedArray(AlignedArray const& cpy) = delete;
+                AlignedArray& operator=(AlignedArray const& rhs) = delete;
+
+                F* data() { return data_; }
+                F const* data() const { return data_; }
+
+                F& operator[](size_t index) { return data_[index]; }
+                F const& operator[](size_t index) const { return data_[index]; }
+
+            private:
+                F* data_;
+            };
+        }
+
+        /**
+         * Struct-of-arrays counterpart of ComponentStorage. Instead of one array of structs per page,
+         * every page holds one aligned array per field, so passes that only touch a few fields only pull
+         * those through the cache, and kernels can work directly on field spans.
+         * Fields are addressed by their index in the field list, e.g. via an enum naming the fields.
+         * Addressing of pages and slots, liveness and change versions are handled by ComponentPages, as for ComponentStorage.
+         */
+        template<size_t PageCount, size_t PageSize, typename... Fields>
+        class SoAComponentStorage : public ComponentPages<std::tuple<detail::AlignedArray<Fields, PageSize>...>, PageCount, PageSize>
+        {
+            using PageStorage = std::tuple<detail::AlignedArray<Fields, PageSize>...>;
+
+        public:
+            template<size_t FieldIndex>
+            using FieldType = std::tuple_element_t<FieldIndex, std::tuple<Fields...>>;
+
+            SoAComponentStorage() = default;
+            ~SoAComponentStorage() = default;
+
+            size_t addComponent(Fields... fields);
+
+            /**
+             * Add cnt components at once. make_component(i, component_index) returns the fields of the i-th
+             * component as std::tuple<Fields...>. Free slots are reused first, the remaining components get
+             * a contiguous range of fresh slots. Takes the storage lock once and the lock of each touched page once.
+             * The indices of the new components are appended to component_indices, in order.
+             */
+            template<typename Function>
+            void addComponents(size_t cnt, Function&& make_component, std::vector<size_t>& component_indices);
+
+            /**
+             * Mark the component as dead and reset its fields. The slot is reused by later additions.
+             */
+            void deleteComponent(size_t component_index);
+
+            template<size_t FieldIndex>
+            FieldType<FieldIndex>& get(size_t page_index, size_t index_in_page);
+
+            template<size_t FieldIndex>
+            FieldType<FieldIndex> const& get(size_t page_index, size_t index_in_page) const;
+
+            /**
+             * All slots of a field in the given page, dead ones included (see getLiveWord).
+             * The span starts at a cache line boundary. Empty if the page is not allocated.
+             */
+            template<size_t FieldIndex>
+            std::span<FieldType<FieldIndex>> getFieldSpan(size_t page_index);
+
+            template<size_t FieldIndex>
+            std::span<FieldType<FieldIndex> const> getFieldSpan(size_t page_index) const;
+
+            /**
+             * Call fn(component_index, page_index, index_in_page) for every live component in the pages [page_begin, page_end).
+             * Disjoint page ranges can be processed concurrently, the storage is not locked.
+             */
+            template<typename Function>
+            void forEachPage(size_t page_begin, size_t page_end, Function&& fn) const;
+
+            template<typename Function>
+            void forEach(Function&& fn) const;
+
+            /**
+             * Like forEachPage, but only visits live components changed after the given version.
+             * Pages without such changes are skipped as a whole. Deletions are not reported.
+             */
+            template<typename Function>
+            void forEachChangedSince(uint64_t version, size_t page_begin, size_t page_end, Function&& fn) const;
+        };
+
+        template<size_t PageCount, size_t PageSize, typename... Fields>
+        inline size_t SoAComponentStorage<PageCount, PageSize, Fields...>::addComponent(Fields... fields)
+        {
+            // write each field to its array
+            return this->addSlot([&fields...](PageStorage& arrays, size_t index_in_page) {
+                std::apply([index_in_page, &fields...](auto&... field_arrays) {
+                    ((field_arrays[index_in_page] = std::move(fields)), ...);
+                }, arrays);
+            });
+        }
+
+        template<size_t PageCount, size_t PageSize, typename... Fields>
+        template<typename Function>
+        inline void SoAComponentStorage<PageCount, PageSize, Fields...>::addComponents(size_t cnt, Function&& make_component, std::vector<size_t>& component_indices)
+        {
+            this->addSlots(cnt,
+                [&make_component](PageStorage& arrays, size_t index_in_page, size_t i, size_t component_index) {
+                    auto fields = make_component(i, component_index);
+
+                    [&]<size_t... Is>(std::index_sequence<Is...>) {
+                        ((std::get<Is>(arrays)[index_in_page] = std::move(std::get<Is>(fields))), ...);
+                    }(std::index_sequence_for<Fields...>());
+                },
+                component_indices);
+        }
+
+        template<size_t PageCount, size_t PageSize, typename... Fields>
+        inline void SoAComponentStorage<PageCount, PageSize, Fields...>::deleteComponent(size_t component_index)
+        {
+            this->deleteSlot(component_index, [](PageStorage& arrays, size_t index_in_page) {
+                std::apply([index_in_page](auto&... field_arrays) {
+                    ((field_arrays[index_in_page] = std::remove_reference_t<decltype(field_arrays[index_in_page])>()), ...);
+                }, arrays);
+            });
+        }
+
+        template<size_t PageCount, size_t PageSize, typename... Fields>
+        template<size_t FieldIndex>
+        inline typename SoAComponentStorage<PageCount, PageSize, Fields...>::template FieldType<FieldIndex>&
+            SoAComponentStorage<PageCount, PageSize, Fields...>::get(size_t page_index, size_t index_in_page)
+        {
+            return std::get<FieldIndex>(this->getPageStorage(page_index))[index_in_page];
+        }
+
+        template<size_t PageCount, size_t PageSize, typename... Fields>
+        template<size_t FieldIndex>
+        inline typename SoAComponentStorage<PageCount, PageSize, Fields...>::template FieldType<FieldIndex> const&
+            SoAComponentStorage<PageCount, PageSize, Fields...>::get(size_t page_index, size_t index_in_page) const
+        {
+            return std::get<FieldIndex>(this->getPageStorage(page_index))[index_in_page];
+        }
+
+        template<size_t PageCount, size_t PageSize, typename... Fields>
+        template<size_t FieldIndex>
+        inline std::span<typename SoAComponentStorage<PageCount, PageSize, Fields...>::template FieldType<FieldIndex>>
+            SoAComponentStorage<PageCount, PageSize, Fields...>::getFieldSpan(size_t page_index)
+        {
+            if (!this->checkPage(page_index)) {
+                return {};
+            }
+
+            return { std::get<FieldIndex>(this->getPageStorage(page_index)).data(), PageSize };
+        }
+
+        template<size_t PageCount, size_t PageSize, typename... Fields>
+        template<size_t FieldIndex>
+        inline std::span<typename SoAComponentStorage<PageCount, PageSize, Fields...>::template FieldType<FieldIndex> const>
+            SoAComponentStorage<PageCount, PageSize, Fields...>::getFieldSpan(size_t page_index) const
+        {
+            if (!this->checkPage(page_index)) {
+                return {};
+            }
+
+            return { std::get<FieldIndex>(this->getPageStorage(page_index)).data(), PageSize };
+        }
+
+        template<size_t PageCount, size_t PageSize, typename... Fields>
+        template<typename Function>
+        inline void SoAComponentStorage<PageCount, PageSize, Fields...>::forEachPage(size_t page_begin, size_t page_end, Function&& fn) const
+        {
+            this->visitLiveSlots(page_begin, page_end, 0, fn);
+        }
+
+        template<size_t PageCount, size_t PageSize, typename... Fields>
+        template<typename Function>
+        inline void SoAComponentStorage<PageCount, PageSize, Fields...>::forEachChangedSince(uint64_t version, size_t page_begin, size_t page_end, Function&& fn) const
+        {
+            this->visitLiveSlots(page_begin, page_end, version, fn);
+        }
+
+        template<size_t PageCount, size_t PageSize, typename... Fields>
+        template<typename Function>
+        inline void SoAComponentStorage<PageCount, PageSize, Fields...>::forEach(Function&& fn) const
+        {
+            forEachPage(0, this->getUsedPageCount(), std::forward<Function>(fn));
+        }
+
+    }
+}
+
+#endif // !SoAComponentStorage_hpp
@@ -81,7 +81,20 @@ namespace EngineCore
 
         void SunlightComponentManager::deleteComonent(Entity entity)
         {
-            // std::unique_lock<std::shared_mutex> lock(m_data_access_mutex);
+            deleteComponents(std::span<Entity const>(&entity, 1));
+        }
+
+        void SunlightComponentManager::deleteComponents(std::span<Entity const> entities)
+        {
+            std::unique_lock<std::shared_mutex> lock(m_data_access_mutex);
+
+            m_data.used = static_cast<uint>(compactComponents(entities, m_data.used,
+                [this](size_t src_index, size_t dst_index) {
+                    m_data.entity[dst_index] = m_data.entity[src_index];
+                    m_data.light_colour[dst_index] = m_data.light_colour[src_index];
+                    m_data.lumen[dst_index] = m_data.lumen[src_index];
+                    m_data.star_radius[dst_index] = m_data.star_radius[src_index];
+                }));
         }
 
         void SunlightComponentManager::setColour(uint index, Vec3 colour)
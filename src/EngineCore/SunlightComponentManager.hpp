@@ -39,6 +39,8 @@ namespace EngineCore
 
             void deleteComonent(Entity entity);
 
+            void deleteComponents(std::span<Entity const> entities) override;
+
             uint getComponentCount() const { return m_data.used; }
 
             void setColour(uint index, Vec3 colour);
@@ -7,33 +7,32 @@ using namespace EngineCore::Animation;
 
 void TagAlongComponentManager::addComponent(Entity entity, Entity target, Vec3 offset, float time_to_target, float deadzone)
 {
-    std::unique_lock<std::shared_mutex> lock(m_tag_data_access_mutex);
+    m_tag_data.modify([this, entity, target, offset, time_to_target, deadzone](std::vector<Data>& data) {
+        size_t idx = data.size();
 
-    size_t idx = m_tag_data.size();
+        addIndex(entity.id(), idx);
 
-    addIndex(entity.id(), idx);
+        data.push_back(Data(entity, target, offset, time_to_target, deadzone));
+    });
+}
 
-    m_tag_data.push_back(Data(entity, target, offset, time_to_target, deadzone));
+void TagAlongComponentManager::deleteComponents(std::span<Entity const> entities)
+{
+    m_tag_data.modify([this, entities](std::vector<Data>& data) {
+        eraseComponents(entities, data);
+    });
 }
 
 void EngineCore::Animation::TagAlongComponentManager::setTarget(Entity entity, Entity target)
 {
-    std::unique_lock<std::shared_mutex> lock(m_tag_data_access_mutex);
-
-    size_t idx = getIndex(entity);
+    m_tag_data.modify([this, entity, target](std::vector<Data>& data) {
+        size_t idx = getIndex(entity);
 
-    m_tag_data[idx].target = target;
+        data[idx].target = target;
+    });
 }
 
-std::vector<TagAlongComponentManager::Data> TagAlongComponentManager::getTagComponentDataCopy()
+EngineCore::Utility::SnapshotVector<TagAlongComponentManager::Data>::Snapshot TagAlongComponentManager::getTagComponentDataSnapshot() const
 {
-    std::vector<TagAlongComponentManager::Data> retval;
-
-    {
-        std::shared_lock<std::shared_mutex> lock(m_tag_data_access_mutex);
-
-        retval = m_tag_data;
-    }
-
-    return retval;
+    return m_tag_data.getSnapshot();
 }
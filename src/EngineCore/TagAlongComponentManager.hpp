@@ -8,6 +8,7 @@
 
 #include "BaseSingleInstanceComponentManager.hpp"
 #include "EntityManager.hpp"
+#include "SnapshotVector.hpp"
 
 // TODO: documentation
 
@@ -32,8 +33,7 @@ namespace EngineCore
                 float  deadzone; ///< Distance from the target location at which the entity starts moving towards the target
             };
 
-            std::vector<Data> m_tag_data;
-            std::shared_mutex m_tag_data_access_mutex;
+            Utility::SnapshotVector<Data> m_tag_data;
 
         public:
             TagAlongComponentManager() = default;
@@ -41,11 +41,14 @@ namespace EngineCore
 
             void addComponent(Entity entity, Entity target, Vec3 offset, float time_to_target, float deadzone = 0.0f);
 
-            // TOOD: deleteComponent
+            void deleteComponents(std::span<Entity const> entities) override;
 
             void setTarget(Entity entity, Entity target);
 
-            std::vector<Data> getTagComponentDataCopy();
+            /**
+             * Immutable snapshot of all components, only copied if components changed since the last snapshot.
+             */
+            Utility::SnapshotVector<Data>::Snapshot getTagComponentDataSnapshot() const;
         };
     }
 }
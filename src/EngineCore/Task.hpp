@@ -0,0 +1,209 @@
+#ifndef Task_hpp
+#define Task_hpp
+
+#include <cassert>
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace EngineCore
+{
+    namespace Utility
+    {
+
+        /**
+         * Move-only type-erased callable for tasks submitted to the TaskScheduler.
+         * Callables of up to inline_capacity bytes are stored in place, i.e. without heap allocation,
+         * larger ones fall back to the heap.
+         */
+        class Task
+        {
+        public:
+            static constexpr size_t inline_capacity = 64;
+
+            Task() noexcept : vtable_(nullptr) {}
+
+            template<typename Function, typename = std::enable_if_t<!std::is_same_v<std::decay_t<Function>, Task>>>
+            Task(Function&& f);
+
+            Task(Task&& other) noexcept;
+
+            Task& operator=(Task&& rhs) noexcept;
+
+            Task(Task const& cpy) = delete;
+            Task& operator=(Task const& rhs) = delete;
+
+            ~Task() { reset(); }
+
+            void operator()();
+
+            explicit operator bool() const { return vtable_ != nullptr; }
+
+            /** Destroy the stored callable, leaving an empty task */
+            void reset() noexcept;
+
+        private:
+            struct VTable
+            {
+                void(*invoke)(void* storage);
+                /** Move-construct callable into uninitialized dst and destroy the callable in src */
+                void(*relocate)(void* dst, void* src) noexcept;
+                void(*destroy)(void* storage) noexcept;
+            };
+
+            template<typename Function>
+            static constexpr bool fits_inline = (sizeof(Function) <= inline_capacity)
+                && (alignof(Function) <= alignof(std::max_align_t))
+                && std::is_nothrow_move_constructible_v<Function>;
+
+            template<typename Function>
+            static VTable const* inlineVTable();
+
+            template<typename Function>
+            static VTable const* heapVTable();
+
+            alignas(std::max_align_t) unsigned char storage_[inline_capacity];
+            VTable const*                           vtable_;
+        };
+
+        /**
+         * Growable FIFO backed by a ring buffer. Unlike std::queue, it keeps its storage when emptied,
+         * so pushing and popping does not allocate once the capacity has settled.
+         */
+        template<typename T>
+        class RingQueue
+        {
+        public:
+            RingQueue() : head_(0), size_(0) {}
+
+            void push(T&& val)
+            {
+                if (size_ == storage_.size()) {
+                    grow();
+                }
+                storage_[(head_ + size_) % storage_.size()] = std::move(val);
+                ++size_;
+            }
+
+            T pop()
+            {
+                assert(size_ > 0);
+                T retval = std::move(storage_[head_]);
+                head_ = (head_ + 1) % storage_.size();
+                --size_;
+                return retval;
+            }
+
+            bool empty() const { return size_ == 0; }
+
+            size_t size() const { return size_; }
+
+        private:
+            void grow()
+            {
+                std::vector<T> new_storage(storage_.empty() ? 64 : storage_.size() * 2);
+                for (size_t i = 0; i < size_; ++i) {
+                    new_storage[i] = std::move(storage_[(head_ + i) % storage_.size()]);
+                }
+                storage_ = std::move(new_storage);
+                head_ = 0;
+            }
+
+            std::vector<T> storage_;
+            size_t         head_;
+            size_t         size_;
+        };
+
+        typedef RingQueue<Task> TaskQueue;
+
+        template<typename Function, typename>
+        inline Task::Task(Function&& f)
+        {
+            using FunctionType = std::decay_t<Function>;
+
+            if constexpr (fits_inline<FunctionType>)
+            {
+                ::new (static_cast<void*>(storage_)) FunctionType(std::forward<Function>(f));
+                vtable_ = inlineVTable<FunctionType>();
+            }
+            else
+            {
+                ::new (static_cast<void*>(storage_)) FunctionType*(new FunctionType(std::forward<Function>(f)));
+                vtable_ = heapVTable<FunctionType>();
+            }
+        }
+
+        inline Task::Task(Task&& other) noexcept
+            : vtable_(other.vtable_)
+        {
+            if (vtable_ != nullptr)
+            {
+                vtable_->relocate(storage_, other.storage_);
+                other.vtable_ = nullptr;
+            }
+        }
+
+        inline Task& Task::operator=(Task&& rhs) noexcept
+        {
+            if (this != &rhs)
+            {
+                reset();
+
+                if (rhs.vtable_ != nullptr)
+                {
+                    rhs.vtable_->relocate(storage_, rhs.storage_);
+                    vtable_ = rhs.vtable_;
+                    rhs.vtable_ = nullptr;
+                }
+            }
+
+            return *this;
+        }
+
+        inline void Task::operator()()
+        {
+            assert(vtable_ != nullptr);
+            vtable_->invoke(storage_);
+        }
+
+        inline void Task::reset() noexcept
+        {
+            if (vtable_ != nullptr)
+            {
+                vtable_->destroy(storage_);
+                vtable_ = nullptr;
+            }
+        }
+
+        template<typename Function>
+        inline Task::VTable const* Task::inlineVTable()
+        {
+            static constexpr VTable vtable{
+                [](void* storage) { (*std::launder(reinterpret_cast<Function*>(storage)))(); },
+                [](void* dst, void* src) noexcept {
+                    Function* src_function = std::launder(reinterpret_cast<Function*>(src));
+                    ::new (dst) Function(std::move(*src_function));
+                    src_function->~Function();
+                },
+                [](void* storage) noexcept { std::launder(reinterpret_cast<Function*>(storage))->~Function(); }
+            };
+            return &vtable;
+        }
+
+        template<typename Function>
+        inline Task::VTable const* Task::heapVTable()
+        {
+            static constexpr VTable vtable{
+                [](void* storage) { (**std::launder(reinterpret_cast<Function**>(storage)))(); },
+                [](void* dst, void* src) noexcept { ::new (dst) Function*(*std::launder(reinterpret_cast<Function**>(src))); },
+                [](void* storage) noexcept { delete *std::launder(reinterpret_cast<Function**>(storage)); }
+            };
+            return &vtable;
+        }
+
+    }
+}
+
+#endif // !Task_hpp
@@ -1,42 +1,267 @@
 #include "TaskScheduler.hpp"
 
+#include <algorithm>
+#include <cmath>
 #include <iostream>
 
-void EngineCore::Utility::TaskScheduler::run(int worker_thread_cnt)
+namespace
 {
+    using EngineCore::Utility::Task;
+
+    /** Scheduler and worker index of the calling thread, used to route submissions of worker threads to their own deque */
+    thread_local EngineCore::Utility::TaskScheduler const* tls_scheduler = nullptr;
+    thread_local int tls_worker_idx = -1;
+
+    /**
+     * Recycles the task objects referenced by the work stealing deques.
+     * Each thread keeps a local cache, tasks are exchanged in batches with a shared pool because
+     * tasks are typically released by a different thread than the one that acquired them.
+     */
+    class TaskPool
+    {
+    public:
+        static Task* acquire()
+        {
+            auto& cache = localCache().tasks;
+
+            if (cache.empty()) {
+                sharedPool().take(cache);
+            }
+
+            if (cache.empty()) {
+                return new Task();
+            }
+
+            Task* retval = cache.back();
+            cache.pop_back();
+            return retval;
+        }
+
+        static void release(Task* task)
+        {
+            task->reset();
+
+            auto& cache = localCache().tasks;
+            cache.push_back(task);
+
+            if (cache.size() >= 2 * batch_size) {
+                sharedPool().give(cache, batch_size);
+            }
+        }
+
+    private:
+        static constexpr size_t batch_size = 256;
+
+        struct SharedPool
+        {
+            ~SharedPool()
+            {
+                for (auto task : tasks) {
+                    delete task;
+                }
+            }
+
+            void take(std::vector<Task*>& cache)
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                size_t cnt = std::min(batch_size, tasks.size());
+                cache.insert(cache.end(), tasks.end() - cnt, tasks.end());
+                tasks.resize(tasks.size() - cnt);
+            }
+
+            void give(std::vector<Task*>& cache, size_t cnt)
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                tasks.insert(tasks.end(), cache.end() - cnt, cache.end());
+                cache.resize(cache.size() - cnt);
+            }
+
+            std::mutex         mutex;
+            std::vector<Task*> tasks;
+        };
+
+        struct LocalCache
+        {
+            LocalCache() { tasks.reserve(2 * batch_size); }
+            ~LocalCache() { sharedPool().give(tasks, tasks.size()); }
+
+            std::vector<Task*> tasks;
+        };
+
+        static SharedPool& sharedPool()
+        {
+            static SharedPool pool;
+            return pool;
+        }
+
+        static LocalCache& localCache()
+        {
+            thread_local LocalCache cache;
+            return cache;
+        }
+    };
+}
+
+EngineCore::Utility::TaskGroup::TaskGroup()
+    : state_(std::make_shared<State>())
+{
+    state_->pending_cnt = 0;
+    state_->waiting_cnt = 0;
+}
+
+bool EngineCore::Utility::TaskGroup::done() const
+{
+    return (state_->pending_cnt.load() == 0);
+}
+
+size_t EngineCore::Utility::TaskGroup::getPendingTaskCount() const
+{
+    return static_cast<size_t>(state_->pending_cnt.load());
+}
+
+bool EngineCore::Utility::TaskGroup::runTask(State& state)
+{
+    Task task;
+
+    {
+        std::lock_guard<std::mutex> lock(state.mutex);
+
+        if (state.tasks.empty()) {
+            return false;
+        }
+
+        task = state.tasks.pop();
+    }
+
+    task();
+
+    if ((--state.pending_cnt == 0) && (state.waiting_cnt.load() > 0))
+    {
+        {
+            std::lock_guard<std::mutex> lock(state.mutex);
+        }
+        state.cvar.notify_all();
+    }
+
+    return true;
+}
+
+void EngineCore::Utility::TaskScheduler::run(int worker_thread_cnt, Mode mode)
+{
+    // unpinned workers, all treated as being on the same node
+    std::vector<CpuTopology::LogicalCore> worker_cores(worker_thread_cnt, CpuTopology::LogicalCore{ -1, -1, 0, 0 });
+
+    render_thread_core_ = -1;
+    startWorkers(mode, worker_cores, 1, false);
+}
+
+void EngineCore::Utility::TaskScheduler::run(Config const& config)
+{
+    CpuTopology topology = CpuTopology::detect();
+
+    render_thread_core_ = -1;
+    int reserved_physical_core = -1;
+
+    if (config.reserve_render_thread_core && topology.getPhysicalCoreCount() > 1)
+    {
+        reserved_physical_core = topology.logical_cores.front().physical_core;
+        render_thread_core_ = topology.logical_cores.front().id;
+    }
+
+    // use one logical core of each physical core first, SMT siblings only once all physical cores are taken
+    std::vector<CpuTopology::LogicalCore> candidate_cores;
+    std::vector<CpuTopology::LogicalCore> smt_sibling_cores;
+    std::vector<int> used_physical_cores;
+
+    for (auto const& core : topology.logical_cores)
+    {
+        if (core.physical_core == reserved_physical_core) {
+            continue;
+        }
+
+        if (std::find(used_physical_cores.begin(), used_physical_cores.end(), core.physical_core) == used_physical_cores.end())
+        {
+            used_physical_cores.push_back(core.physical_core);
+            candidate_cores.push_back(core);
+        }
+        else
+        {
+            smt_sibling_cores.push_back(core);
+        }
+    }
+
+    int worker_thread_cnt = (config.worker_thread_cnt > 0) ? config.worker_thread_cnt : static_cast<int>(candidate_cores.size());
+    candidate_cores.insert(candidate_cores.end(), smt_sibling_cores.begin(), smt_sibling_cores.end());
+
+    std::vector<CpuTopology::LogicalCore> worker_cores;
+    for (int i = 0; i < worker_thread_cnt; ++i) {
+        worker_cores.push_back(candidate_cores[i % candidate_cores.size()]);
+    }
+
+    std::stable_sort(worker_cores.begin(), worker_cores.end(), [](CpuTopology::LogicalCore const& lhs, CpuTopology::LogicalCore const& rhs) {
+        return lhs.numa_node < rhs.numa_node;
+    });
+
+    startWorkers(config.mode, worker_cores, topology.numa_node_cnt, config.pin_worker_threads);
+}
+
+void EngineCore::Utility::TaskScheduler::startWorkers(Mode mode, std::vector<CpuTopology::LogicalCore> const& worker_cores, int numa_node_cnt, bool pin_worker_threads)
+{
+    int worker_thread_cnt = static_cast<int>(worker_cores.size());
+
+    mode_ = mode;
     worker_thread_pool_.resize(worker_thread_cnt);
     task_schedueler_active_.test_and_set();
     busy_threads_cnt_ = 0;
     tasks_cnt_ = 0;
+    injection_cnt_ = 0;
+    sleeping_workers_cnt_ = 0;
 
+    telemetry_.reset(worker_thread_cnt);
+
+    numa_node_workers_.assign(std::max(1, numa_node_cnt), { 0, 0 });
     for (int i = 0; i < worker_thread_cnt; ++i)
     {
-        worker_thread_pool_[i] = std::thread([this]() {
-            while (task_schedueler_active_.test())
-            {
-                std::function<void()> task;
-                bool success = false;
+        auto& range = numa_node_workers_[worker_cores[i].numa_node];
+        if (range.first == range.second) {
+            range = { i, i };
+        }
+        range.second = i + 1;
+    }
 
-                {
-                    // atomically try to pop task from queue and increment busy if successful
-                    std::unique_lock<std::mutex> lock(mutex_);
-                    cvar_.wait(lock, [this] { return (tasks_cnt_.load() > 0); });
-                    task = std::move(queue_.front());
-                    queue_.pop();
-                    --tasks_cnt_;
-                    ++busy_threads_cnt_;
-                    success = true;
-                }
+    if (mode_ == Mode::WORK_STEALING)
+    {
+        workers_.clear();
+        for (int i = 0; i < worker_thread_cnt; ++i)
+        {
+            workers_.push_back(std::make_unique<Worker>());
+            workers_.back()->rng_state = 0x9E3779B9u * static_cast<uint32_t>(i + 1);
+            workers_.back()->numa_node = worker_cores[i].numa_node;
+        }
+    }
 
-                if (success)
-                {
-                    task();
-                    --busy_threads_cnt_;
-                }
+    for (int i = 0; i < worker_thread_cnt; ++i)
+    {
+        int core_id = pin_worker_threads ? worker_cores[i].id : -1;
 
-                cvar_.notify_all();
-            }
+        if (mode_ == Mode::WORK_STEALING)
+        {
+            worker_thread_pool_[i] = std::thread([this, i, core_id]() {
+                if (core_id >= 0) {
+                    CpuTopology::pinCurrentThread(core_id);
+                }
+                runWorkStealingWorker(i);
+            });
+        }
+        else
+        {
+            worker_thread_pool_[i] = std::thread([this, i, core_id]() {
+                if (core_id >= 0) {
+                    CpuTopology::pinCurrentThread(core_id);
+                }
+                runSharedQueueWorker(i);
             });
+        }
     }
 }
 
@@ -44,18 +269,112 @@ void EngineCore::Utility::TaskScheduler::stop()
 {
     task_schedueler_active_.clear();
 
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+    }
+    cvar_.notify_all();
+
+    for (auto& worker : workers_)
+    {
+        {
+            std::lock_guard<std::mutex> lock(worker->sleep_mutex);
+            worker->wake_up = true;
+        }
+        worker->sleep_cvar.notify_one();
+    }
+
     for (auto& thread : worker_thread_pool_)
         thread.join();
+
+    worker_thread_pool_.clear();
+
+    // clean up tasks that were never executed
+    for (auto& worker : workers_)
+    {
+        Task* task = nullptr;
+        while (worker->deque.pop(task)) {
+            TaskPool::release(task);
+        }
+    }
+    workers_.clear();
+
+    while (!injection_queue_.empty()) {
+        TaskPool::release(injection_queue_.pop());
+    }
 }
 
-void EngineCore::Utility::TaskScheduler::submitTask(Task new_task)
+void EngineCore::Utility::TaskScheduler::submitTask(Task&& new_task)
 {
+    if (mode_ == Mode::WORK_STEALING)
     {
-        std::lock_guard<std::mutex> lock(mutex_);
-        queue_.push(new_task);
+        Task* task = TaskPool::acquire();
+        *task = std::move(new_task);
         ++tasks_cnt_;
+
+        if (tls_scheduler == this && tls_worker_idx >= 0)
+        {
+            workers_[tls_worker_idx]->deque.push(task);
+        }
+        else
+        {
+            std::lock_guard<std::mutex> lock(injection_mutex_);
+            injection_queue_.push(std::move(task));
+            ++injection_cnt_;
+        }
+
+        // make task visible before checking for sleeping workers (pairs with fence in runWorkStealingWorker)
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        wakeUpWorker();
+    }
+    else
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            queue_.push(std::move(new_task));
+            ++tasks_cnt_;
+        }
+        cvar_.notify_all();
+    }
+}
+
+void EngineCore::Utility::TaskScheduler::submitTask(Task&& new_task, TaskGroup& group)
+{
+    {
+        std::lock_guard<std::mutex> lock(group.state_->mutex);
+        group.state_->tasks.push(std::move(new_task));
+        ++group.state_->pending_cnt;
+    }
+
+    submitGroupProxies(group.state_, 1);
+}
+
+void EngineCore::Utility::TaskScheduler::submitTasks(std::vector<Task>&& new_tasks, TaskGroup& group)
+{
+    auto state = group.state_;
+
+    {
+        std::lock_guard<std::mutex> lock(state->mutex);
+        for (auto& task : new_tasks) {
+            state->tasks.push(std::move(task));
+        }
+        state->pending_cnt += static_cast<int>(new_tasks.size());
+    }
+
+    submitGroupProxies(state, new_tasks.size());
+}
+
+void EngineCore::Utility::TaskScheduler::submitGroupProxies(std::shared_ptr<TaskGroup::State> const& state, size_t cnt)
+{
+    // wake up threads helping with the group
+    if (state->waiting_cnt.load() > 0) {
+        state->cvar.notify_all();
+    }
+
+    // the scheduler only receives proxies that execute whichever group task is next in line,
+    // proxies find the group empty if a helping thread was faster
+    for (size_t i = 0; i < cnt; ++i) {
+        submitTask([state]() { TaskGroup::runTask(*state); });
     }
-    cvar_.notify_all();
 }
 
 bool EngineCore::Utility::TaskScheduler::empty() const {
@@ -64,8 +383,359 @@ bool EngineCore::Utility::TaskScheduler::empty() const {
 
 void EngineCore::Utility::TaskScheduler::waitWhileBusy()
 {
-    // pessimistic wait while busy that checks every 0.01ms if acutally still busy,
-    // because it sometimes somehow misses the notifications from the worker threads
     std::unique_lock<std::mutex> lock(mutex_);
-    while (!cvar_.wait_for(lock, std::chrono::microseconds(10), [this] { return (tasks_cnt_.load() == 0) && (busy_threads_cnt_.load() == 0); }));
+    cvar_.wait(lock, [this] { return (tasks_cnt_.load() == 0) && (busy_threads_cnt_.load() == 0); });
+}
+
+void EngineCore::Utility::TaskScheduler::wait(TaskGroup& group)
+{
+    auto& state = *group.state_;
+
+    while (state.pending_cnt.load() > 0)
+    {
+        // help out with tasks of the group that have not been picked up by a worker yet
+        if (TaskGroup::runTask(state)) {
+            continue;
+        }
+
+        // all remaining tasks are in flight on other threads, wait for them or for new tasks added to the group
+        ++state.waiting_cnt;
+        {
+            std::unique_lock<std::mutex> lock(state.mutex);
+            state.cvar.wait(lock, [&state] { return (state.pending_cnt.load() == 0) || !state.tasks.empty(); });
+        }
+        --state.waiting_cnt;
+    }
+}
+
+EngineCore::Utility::TaskScheduler::Mode EngineCore::Utility::TaskScheduler::getMode() const
+{
+    return mode_;
+}
+
+int EngineCore::Utility::TaskScheduler::getWorkerThreadCount() const
+{
+    return static_cast<int>(worker_thread_pool_.size());
+}
+
+int EngineCore::Utility::TaskScheduler::getRenderThreadCore() const
+{
+    return render_thread_core_;
+}
+
+EngineCore::Utility::SchedulerTelemetry& EngineCore::Utility::TaskScheduler::getTelemetry()
+{
+    return telemetry_;
+}
+
+EngineCore::Utility::SchedulerTelemetry const& EngineCore::Utility::TaskScheduler::getTelemetry() const
+{
+    return telemetry_;
+}
+
+size_t EngineCore::Utility::TaskScheduler::computeGrainSize(size_t item_cnt, double ns_per_item) const
+{
+    size_t worker_cnt = std::max<size_t>(1, worker_thread_pool_.size());
+
+    // an immeasurably cheap item counts as the whole range not being worth the overhead
+    size_t min_grain_size = (ns_per_item > 0.0)
+        ? static_cast<size_t>(std::ceil(min_chunk_duration_ns_ / ns_per_item))
+        : item_cnt;
+
+    size_t balanced_grain_size = (item_cnt + (worker_cnt * chunks_per_worker_) - 1) / (worker_cnt * chunks_per_worker_);
+
+    return std::max<size_t>(1, std::max(min_grain_size, balanced_grain_size));
+}
+
+void EngineCore::Utility::TaskScheduler::runSharedQueueWorker(int worker_idx)
+{
+    while (task_schedueler_active_.test())
+    {
+        Task task;
+        uint64_t queue_depth = 0;
+
+        {
+            // atomically try to pop task from queue and increment busy if successful
+            std::unique_lock<std::mutex> lock(mutex_);
+
+            if (telemetry_.isEnabled() && tasks_cnt_.load() == 0)
+            {
+                uint64_t idle_begin_ns = telemetry_.now();
+                cvar_.wait(lock, [this] { return (tasks_cnt_.load() > 0) || !task_schedueler_active_.test(); });
+                telemetry_.getWorkerBuffer(worker_idx).record({ SchedulerTelemetry::EventType::IDLE, idle_begin_ns, telemetry_.now(), 0 });
+            }
+            else
+            {
+                cvar_.wait(lock, [this] { return (tasks_cnt_.load() > 0) || !task_schedueler_active_.test(); });
+            }
+
+            if (tasks_cnt_.load() == 0) {
+                break;
+            }
+
+            task = queue_.pop();
+            queue_depth = static_cast<uint64_t>(tasks_cnt_.load());
+            --tasks_cnt_;
+            ++busy_threads_cnt_;
+        }
+
+        if (telemetry_.isEnabled())
+        {
+            uint64_t begin_ns = telemetry_.now();
+            task();
+            telemetry_.getWorkerBuffer(worker_idx).record({ SchedulerTelemetry::EventType::TASK, begin_ns, telemetry_.now(), queue_depth });
+        }
+        else
+        {
+            task();
+        }
+        --busy_threads_cnt_;
+
+        // lock before notifying, otherwise waitWhileBusy might miss the notification
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+        }
+        cvar_.notify_all();
+    }
+}
+
+void EngineCore::Utility::TaskScheduler::runWorkStealingWorker(int worker_idx)
+{
+    tls_scheduler = this;
+    tls_worker_idx = worker_idx;
+
+    Worker& worker = *workers_[worker_idx];
+
+    // idle time is measured from the first unsuccessful search for a task until a task is found
+    bool idle = false;
+    uint64_t idle_begin_ns = 0;
+
+    auto end_idle = [this, worker_idx, &idle, &idle_begin_ns]() {
+        if (idle)
+        {
+            telemetry_.getWorkerBuffer(worker_idx).record({ SchedulerTelemetry::EventType::IDLE, idle_begin_ns, telemetry_.now(), 0 });
+            idle = false;
+        }
+    };
+
+    while (task_schedueler_active_.test())
+    {
+        Task* task = findTask(worker_idx);
+
+        if (task == nullptr && !idle && telemetry_.isEnabled())
+        {
+            idle = true;
+            idle_begin_ns = telemetry_.now();
+        }
+
+        // spin for a short while before going to sleep, new tasks often arrive in bursts
+        for (int i = 0; (i < 64) && (task == nullptr); ++i)
+        {
+            std::this_thread::yield();
+            task = findTask(worker_idx);
+        }
+
+        if (task != nullptr)
+        {
+            end_idle();
+            executeTask(task, worker_idx);
+            continue;
+        }
+
+        // register as sleeping and check once more for tasks that were submitted in the meantime
+        {
+            std::lock_guard<std::mutex> lock(sleeping_workers_mutex_);
+            sleeping_workers_.push_back(worker_idx);
+            ++sleeping_workers_cnt_;
+        }
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+
+        task = findTask(worker_idx);
+
+        if (task != nullptr)
+        {
+            bool woken_up = true;
+            {
+                std::lock_guard<std::mutex> lock(sleeping_workers_mutex_);
+                auto query = std::find(sleeping_workers_.begin(), sleeping_workers_.end(), worker_idx);
+                if (query != sleeping_workers_.end())
+                {
+                    sleeping_workers_.erase(query);
+                    --sleeping_workers_cnt_;
+                    woken_up = false;
+                }
+            }
+
+            if (woken_up)
+            {
+                // a submitter already picked this worker for waking up, pass the wake-up on
+                {
+                    std::lock_guard<std::mutex> lock(worker.sleep_mutex);
+                    worker.wake_up = false;
+                }
+                wakeUpWorker();
+            }
+
+            end_idle();
+            executeTask(task, worker_idx);
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(worker.sleep_mutex);
+        worker.sleep_cvar.wait(lock, [this, &worker] { return worker.wake_up || !task_schedueler_active_.test(); });
+        worker.wake_up = false;
+    }
+
+    tls_scheduler = nullptr;
+    tls_worker_idx = -1;
+}
+
+EngineCore::Utility::Task* EngineCore::Utility::TaskScheduler::findTask(int worker_idx)
+{
+    Task* task = nullptr;
+
+    if (workers_[worker_idx]->deque.pop(task)) {
+        return task;
+    }
+
+    if (injection_cnt_.load(std::memory_order_relaxed) > 0)
+    {
+        std::lock_guard<std::mutex> lock(injection_mutex_);
+
+        if (!injection_queue_.empty())
+        {
+            task = injection_queue_.pop();
+            --injection_cnt_;
+
+            // move a fair share of the remaining injected tasks to the own deque to make them available for stealing
+            size_t batch_size = injection_queue_.size() / workers_.size();
+            for (size_t i = 0; i < batch_size; ++i)
+            {
+                workers_[worker_idx]->deque.push(injection_queue_.pop());
+                --injection_cnt_;
+            }
+
+            return task;
+        }
+    }
+
+    return stealTask(worker_idx);
+}
+
+EngineCore::Utility::Task* EngineCore::Utility::TaskScheduler::stealTask(int thief_idx)
+{
+    int worker_cnt = static_cast<int>(workers_.size());
+
+    if (worker_cnt < 2) {
+        return nullptr;
+    }
+
+    // xorshift32 for picking a random first victim
+    uint32_t x = workers_[thief_idx]->rng_state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    workers_[thief_idx]->rng_state = x;
+
+    // tasks of workers on the same node likely work on data in node-local memory
+    auto [local_begin, local_end] = numa_node_workers_[workers_[thief_idx]->numa_node];
+
+    Task* task = stealTask(thief_idx, local_begin, local_end, x);
+
+    if (task == nullptr && (local_end - local_begin) < worker_cnt) {
+        task = stealTask(thief_idx, 0, worker_cnt, x);
+    }
+
+    if (task != nullptr && telemetry_.isEnabled()) {
+        telemetry_.getWorkerBuffer(thief_idx).recordSteal();
+    }
+
+    return task;
+}
+
+EngineCore::Utility::Task* EngineCore::Utility::TaskScheduler::stealTask(int thief_idx, int victims_begin, int victims_end, uint32_t random)
+{
+    int victim_cnt = victims_end - victims_begin;
+
+    if (victim_cnt <= 0) {
+        return nullptr;
+    }
+
+    int start_idx = static_cast<int>(random % static_cast<uint32_t>(victim_cnt));
+
+    for (int i = 0; i < victim_cnt; ++i)
+    {
+        int victim_idx = victims_begin + (start_idx + i) % victim_cnt;
+
+        if (victim_idx == thief_idx) {
+            continue;
+        }
+
+        Task* task = nullptr;
+        if (workers_[victim_idx]->deque.steal(task)) {
+            return task;
+        }
+    }
+
+    return nullptr;
+}
+
+void EngineCore::Utility::TaskScheduler::executeTask(Task* task, int worker_idx)
+{
+    // increment busy before decrementing queued tasks, so that waitWhileBusy never sees both at zero while a task is in flight
+    ++busy_threads_cnt_;
+    --tasks_cnt_;
+
+    if (telemetry_.isEnabled())
+    {
+        uint64_t queue_depth = workers_[worker_idx]->deque.size() + static_cast<uint64_t>(injection_cnt_.load(std::memory_order_relaxed));
+        uint64_t begin_ns = telemetry_.now();
+
+        (*task)();
+
+        telemetry_.getWorkerBuffer(worker_idx).record({ SchedulerTelemetry::EventType::TASK, begin_ns, telemetry_.now(), queue_depth });
+    }
+    else
+    {
+        (*task)();
+    }
+
+    TaskPool::release(task);
+
+    if (--busy_threads_cnt_ == 0 && tasks_cnt_.load() == 0)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+        }
+        cvar_.notify_all();
+    }
+}
+
+void EngineCore::Utility::TaskScheduler::wakeUpWorker()
+{
+    if (sleeping_workers_cnt_.load() == 0) {
+        return;
+    }
+
+    int worker_idx = -1;
+
+    {
+        std::lock_guard<std::mutex> lock(sleeping_workers_mutex_);
+        if (!sleeping_workers_.empty())
+        {
+            worker_idx = sleeping_workers_.back();
+            sleeping_workers_.pop_back();
+            --sleeping_workers_cnt_;
+        }
+    }
+
+    if (worker_idx >= 0)
+    {
+        Worker& worker = *workers_[worker_idx];
+        {
+            std::lock_guard<std::mutex> lock(worker.sleep_mutex);
+            worker.wake_up = true;
+        }
+        worker.sleep_cvar.notify_one();
+    }
 }
@@ -1,27 +1,93 @@
 #ifndef TaskScheduler_hpp
 #define TaskScheduler_hpp
 
+#include <algorithm>
 #include <atomic>
+#include <chrono>
 #include <condition_variable>
 #include <functional>
+#include <memory>
 
+#include "CpuTopology.hpp"
 #include "MTQueue.hpp"
+#include "SchedulerTelemetry.hpp"
+#include "Task.hpp"
+#include "WorkStealingDeque.hpp"
 
 namespace EngineCore
 {
     namespace Utility
     {
 
-        typedef std::function<void()> Task;
+        /**
+         * Handle for a batch of tasks submitted to a TaskScheduler that can be waited on independently
+         * of all other tasks in the scheduler. Copies of a handle refer to the same group.
+         */
+        class TaskGroup
+        {
+        public:
+            TaskGroup();
+            ~TaskGroup() = default;
+
+            /** Returns true if all tasks submitted to the group so far have finished. */
+            bool done() const;
+
+            size_t getPendingTaskCount() const;
+
+        private:
+            friend class TaskScheduler;
+
+            struct State
+            {
+                /** Tasks of the group that have not been started yet */
+                TaskQueue               tasks;
+                std::mutex              mutex;
+                std::condition_variable cvar;
+
+                /** Tasks of the group that have been submitted but not finished yet */
+                std::atomic_int         pending_cnt;
+                /** Threads currently waiting on the group, used to skip notifications if nobody is waiting */
+                std::atomic_int         waiting_cnt;
+            };
+
+            /** Pop and execute a single not yet started task of the group. Returns false if there was none. */
+            static bool runTask(State& state);
+
+            /** Shared with the scheduler, as proxy tasks in the scheduler queues may outlive the handle */
+            std::shared_ptr<State> state_;
+        };
 
         class TaskScheduler
         {
+        public:
+            enum class Mode
+            {
+                SHARED_QUEUE, ///< all workers pop from a single mutex protected queue
+                WORK_STEALING ///< each worker owns a lock-free deque, idle workers steal from others
+            };
+
+            /**
+             * Worker pool setup based on the detected CPU topology.
+             */
+            struct Config
+            {
+                /** Number of worker threads, 0 picks one per physical core (minus the reserved core) */
+                int  worker_thread_cnt = 0;
+                Mode mode = Mode::WORK_STEALING;
+                /** Pin each worker thread to a logical core, physical cores are filled before SMT siblings */
+                bool pin_worker_threads = false;
+                /** Keep one physical core free of worker threads, see getRenderThreadCore */
+                bool reserve_render_thread_core = false;
+            };
+
         private:
             std::atomic_flag         task_schedueler_active_ = ATOMIC_FLAG_INIT; //TODO replace
             std::vector<std::thread> worker_thread_pool_;
 
-            /** Underlying standard queue. */
-            std::queue<Task>         queue_;
+            Mode                     mode_ = Mode::SHARED_QUEUE;
+
+            /** Underlying task queue. */
+            TaskQueue                queue_;
             /** Mutex to protect task queue operations. */
             mutable std::mutex       mutex_;
             /** Condition variable to wait while busy or for new task*/
@@ -32,19 +98,300 @@ namespace EngineCore
             /** Atomically keep track of tasks currently still in queue */
             std::atomic_int          tasks_cnt_;
 
+            /**
+             * Per-worker state used in work stealing mode.
+             */
+            struct Worker
+            {
+                /** Tasks submitted by the worker itself, popped LIFO by the owner and stolen FIFO by others */
+                WorkStealingDeque<Task*> deque;
+
+                /** State for targeted wake-ups of this specific worker */
+                std::mutex              sleep_mutex;
+                std::condition_variable sleep_cvar;
+                bool                    wake_up = false;
+
+                /** Per-worker state for randomized victim selection (xorshift) */
+                uint32_t                rng_state = 0;
+
+                /**
+                 * NUMA node of the core assigned to the worker, used to prefer stealing within a node.
+                 * Only guaranteed to be the node the worker runs on if workers are pinned, 0 without a Config.
+                 */
+                int                     numa_node = 0;
+            };
+
+            std::vector<std::unique_ptr<Worker>> workers_;
+
+            /** Range [begin, end) of worker indices per NUMA node, workers of a node are contiguous */
+            std::vector<std::pair<int, int>> numa_node_workers_;
+
+            /** Logical core kept free for the render thread, -1 if none */
+            int                      render_thread_core_ = -1;
+
+            SchedulerTelemetry       telemetry_;
+
+            /** Tasks submitted from threads outside of the worker pool (work stealing mode only) */
+            RingQueue<Task*>         injection_queue_;
+            std::mutex               injection_mutex_;
+            std::atomic_int          injection_cnt_;
+
+            /** Indices of workers currently sleeping, used to wake up exactly one worker per submitted task */
+            std::vector<int>         sleeping_workers_;
+            std::mutex               sleeping_workers_mutex_;
+            std::atomic_int          sleeping_workers_cnt_;
+
+            /**
+             * Start one worker thread per given core, pinned to it if requested.
+             * Cores have to be sorted by NUMA node.
+             */
+            void startWorkers(Mode mode, std::vector<CpuTopology::LogicalCore> const& worker_cores, int numa_node_cnt, bool pin_worker_threads);
+
+            void runSharedQueueWorker(int worker_idx);
+
+            void runWorkStealingWorker(int worker_idx);
+
+            /** Try to find a task for the given worker: own deque, then injection queue, then steal from random victims */
+            Task* findTask(int worker_idx);
+
+            /** Steal from victims on the thief's NUMA node first, then from all others */
+            Task* stealTask(int thief_idx);
+
+            Task* stealTask(int thief_idx, int victims_begin, int victims_end, uint32_t random);
+
+            void executeTask(Task* task, int worker_idx);
+
+            void wakeUpWorker();
+
+            /** Submit cnt proxy tasks for tasks that have just been added to the group's queue */
+            void submitGroupProxies(std::shared_ptr<TaskGroup::State> const& state, size_t cnt);
+
+            /**
+             * Execute fn on growing sub-ranges at the start of [begin, end) on the calling thread until
+             * enough time has passed for a meaningful per-item cost estimate.
+             * \return Returns the first unprocessed index and the measured cost per item in nanoseconds
+             */
+            template<typename Function>
+            std::pair<size_t, double> probeItemCost(size_t begin, size_t end, Function& fn);
+
+            /**
+             * Pick a chunk size for splitting a range across the worker threads.
+             * Chunks are large enough to amortize the per-task overhead and small enough
+             * to give each worker several chunks for load balancing.
+             */
+            size_t computeGrainSize(size_t item_cnt, double ns_per_item) const;
+
+            /** Time spent on estimating the cost per item in parallelFor/parallelReduce without grain size hint */
+            static constexpr double probe_duration_ns_ = 10000.0;
+            /** Minimum duration of a chunk, to amortize task submission and execution overhead */
+            static constexpr double min_chunk_duration_ns_ = 50000.0;
+            /** Number of chunks per worker, to leave room for balancing uneven chunk costs */
+            static constexpr size_t chunks_per_worker_ = 4;
+
         public:
-            void run(int worker_thread_cnt);
+            /**
+             * Start the given number of worker threads, without any pinning.
+             */
+            void run(int worker_thread_cnt, Mode mode = Mode::SHARED_QUEUE);
+
+            /**
+             * Start worker threads according to the detected CPU topology.
+             * In work stealing mode, idle workers prefer stealing from workers on their own NUMA node.
+             */
+            void run(Config const& config);
 
             void stop();
 
-            void submitTask(Task new_task);
+            void submitTask(Task&& new_task);
+
+            /**
+             * Submit any callable, which is forwarded into the task's inline storage without intermediate copies.
+             */
+            template<typename Function, typename = std::enable_if_t<!std::is_same_v<std::decay_t<Function>, Task>>>
+            void submitTask(Function&& f) { submitTask(Task(std::forward<Function>(f))); }
+
+            /**
+             * Submit a task as part of the given group.
+             */
+            void submitTask(Task&& new_task, TaskGroup& group);
+
+            template<typename Function, typename = std::enable_if_t<!std::is_same_v<std::decay_t<Function>, Task>>>
+            void submitTask(Function&& f, TaskGroup& group) { submitTask(Task(std::forward<Function>(f)), group); }
+
+            /**
+             * Submit a batch of tasks as part of the given group.
+             */
+            void submitTasks(std::vector<Task>&& new_tasks, TaskGroup& group);
 
             bool empty() const;
 
+            /**
+             * Wait until all tasks of the scheduler are finished. The calling thread does not participate.
+             * Prefer waiting on a TaskGroup, which only waits for the tasks in question.
+             */
             void waitWhileBusy();
+
+            /**
+             * Wait until all tasks of the given group are finished. The calling thread executes not yet
+             * started tasks of the group while waiting (helping wait), so it is safe to call from within a task.
+             */
+            void wait(TaskGroup& group);
+
+            /**
+             * Call fn(from, to) for consecutive sub-ranges covering [begin, end) in parallel and wait for completion.
+             * The calling thread participates. fn has to be safe to call concurrently for disjoint sub-ranges.
+             * \param grain_size Size of the sub-ranges. If 0, the size is chosen based on the worker count and
+             * the cost per item measured on the first items of the range.
+             */
+            template<typename Function>
+            void parallelFor(size_t begin, size_t end, Function&& fn, size_t grain_size = 0);
+
+            /**
+             * Compute map(from, to) for consecutive sub-ranges covering [begin, end) in parallel and combine
+             * the partial results with reduce in order of the sub-ranges, i.e. reduce only has to be associative.
+             * \param grain_size Size of the sub-ranges. If 0, chosen like in parallelFor.
+             */
+            template<typename T, typename MapFunction, typename ReduceFunction>
+            T parallelReduce(size_t begin, size_t end, T identity, MapFunction&& map, ReduceFunction&& reduce, size_t grain_size = 0);
+
+            Mode getMode() const;
+
+            int getWorkerThreadCount() const;
+
+            /**
+             * Logical core reserved for the render thread if requested in the config, -1 otherwise.
+             * The scheduler does not own the render thread, pass the core to GraphicsBackend::setRenderThreadCore
+             * (or call CpuTopology::pinCurrentThread from the render thread) to pin it.
+             */
+            int getRenderThreadCore() const;
+
+            /**
+             * Per-worker task timings, idle times, queue depths and steal counts.
+             * Recording has to be enabled first, data is reset when the worker threads are (re)started.
+             */
+            SchedulerTelemetry& getTelemetry();
+
+            SchedulerTelemetry const& getTelemetry() const;
         };
+
+        template<typename Function>
+        inline std::pair<size_t, double> TaskScheduler::probeItemCost(size_t begin, size_t end, Function& fn)
+        {
+            size_t from = begin;
+            size_t probe_cnt = 1;
+            double elapsed_ns = 0.0;
+
+            while ((from < end) && (elapsed_ns < probe_duration_ns_))
+            {
+                size_t to = std::min(end, from + probe_cnt);
+
+                auto t_0 = std::chrono::steady_clock::now();
+                fn(from, to);
+                auto t_1 = std::chrono::steady_clock::now();
+
+                elapsed_ns += std::chrono::duration<double, std::nano>(t_1 - t_0).count();
+                from = to;
+                probe_cnt *= 2;
+            }
+
+            return { from, elapsed_ns / static_cast<double>(from - begin) };
+        }
+
+        template<typename Function>
+        inline void TaskScheduler::parallelFor(size_t begin, size_t end, Function&& fn, size_t grain_size)
+        {
+            size_t from = begin;
+
+            if (grain_size == 0)
+            {
+                auto [probe_end, ns_per_item] = probeItemCost(begin, end, fn);
+                from = probe_end;
+                grain_size = computeGrainSize(end - from, ns_per_item);
+            }
+
+            if (from >= end) {
+                return;
+            }
+
+            // not worth splitting up, or nobody to split up for
+            if ((end - from) <= grain_size || getWorkerThreadCount() == 0)
+            {
+                fn(from, end);
+                return;
+            }
+
+            std::vector<Task> tasks;
+            tasks.reserve((end - from + grain_size - 1) / grain_size);
+
+            for (size_t chunk_begin = from; chunk_begin < end; chunk_begin += grain_size)
+            {
+                size_t chunk_end = std::min(end, chunk_begin + grain_size);
+                tasks.push_back([&fn, chunk_begin, chunk_end]() { fn(chunk_begin, chunk_end); });
+            }
+
+            TaskGroup task_group;
+            submitTasks(std::move(tasks), task_group);
+            wait(task_group);
+        }
+
+        template<typename T, typename MapFunction, typename ReduceFunction>
+        inline T TaskScheduler::parallelReduce(size_t begin, size_t end, T identity, MapFunction&& map, ReduceFunction&& reduce, size_t grain_size)
+        {
+            T retval = identity;
+            size_t from = begin;
+
+            if (grain_size == 0)
+            {
+                // the probed items are the first in order, so they can be reduced right away
+                auto probe = [&retval, &map, &reduce](size_t probe_from, size_t probe_to) {
+                    retval = reduce(retval, map(probe_from, probe_to));
+                };
+                auto [probe_end, ns_per_item] = probeItemCost(begin, end, probe);
+                from = probe_end;
+                grain_size = computeGrainSize(end - from, ns_per_item);
+            }
+
+            if (from >= end) {
+                return retval;
+            }
+
+            if ((end - from) <= grain_size || getWorkerThreadCount() == 0)
+            {
+                return reduce(retval, map(from, end));
+            }
+
+            size_t chunk_cnt = (end - from + grain_size - 1) / grain_size;
+
+            // one cache line per chunk result, so that concurrent writes neither race (e.g. for the packed std::vector<bool>) nor share lines
+            struct alignas(64) PartialResult
+            {
+                T value;
+            };
+            std::vector<PartialResult> partial_results(chunk_cnt, PartialResult{ identity });
+
+            std::vector<Task> tasks;
+            tasks.reserve(chunk_cnt);
+
+            for (size_t chunk_idx = 0; chunk_idx < chunk_cnt; ++chunk_idx)
+            {
+                size_t chunk_begin = from + chunk_idx * grain_size;
+                size_t chunk_end = std::min(end, chunk_begin + grain_size);
+                tasks.push_back([&map, &partial_results, chunk_idx, chunk_begin, chunk_end]() {
+                    partial_results[chunk_idx].value = map(chunk_begin, chunk_end);
+                });
+            }
+
+            TaskGroup task_group;
+            submitTasks(std::move(tasks), task_group);
+            wait(task_group);
+
+            for (auto& partial_result : partial_results) {
+                retval = reduce(retval, partial_result.value);
+            }
+
+            return retval;
+        }
     }
 }
 
 #endif // !TaskScheduler_hpp
-
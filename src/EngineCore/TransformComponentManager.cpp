@@ -1,11 +1,27 @@
 #include "TransformComponentManager.hpp"
 
+#include <algorithm>
+
 namespace EngineCore
 {
     namespace Common
     {
-        TransformComponentManager::TransformComponentManager()
-            : BaseSingleInstanceComponentManager()
+        namespace
+        {
+            Mat4x4 computeLocalTransform(Vec3 const& position, Quat const& orientation, Vec3 const& scale)
+            {
+                Mat4x4 xform = glm::toMat4(orientation);
+                xform[3] = Vec4(position, 1.0);
+                xform[0] *= scale.x;
+                xform[1] *= scale.y;
+                xform[2] *= scale.z;
+
+                return xform;
+            }
+        }
+
+        TransformComponentManager::TransformComponentManager(Propagation propagation)
+            : BaseSingleInstanceComponentManager(), propagation_(propagation)
         {}
 
         TransformComponentManager::~TransformComponentManager()
@@ -14,16 +30,14 @@ namespace EngineCore
         size_t TransformComponentManager::addComponent(Entity entity, Vec3 position, Quat orientation, Vec3 scale)
         {
             auto index = data_.addComponent(
-                {
-                    entity,
-                    Mat4x4(0.0f),
-                    position,
-                    orientation,
-                    scale,
-                    0,
-                    0,
-                    0
-                }
+                entity,
+                Mat4x4(0.0f),
+                position,
+                orientation,
+                scale,
+                0,
+                0,
+                0
             );
 
             addIndex(entity.id(), index);
@@ -33,21 +47,159 @@ namespace EngineCore
             {
                 auto lock = data_.accquirePageLock(page_idx);
 
-                data_(page_idx, idx_in_page).parent = index;
-                data_(page_idx, idx_in_page).first_child = index;
-                data_(page_idx, idx_in_page).next_sibling = index;
+                data_.get<PARENT>(page_idx, idx_in_page) = index;
+                data_.get<FIRST_CHILD>(page_idx, idx_in_page) = index;
+                data_.get<NEXT_SIBLING>(page_idx, idx_in_page) = index;
             }
 
-            transform(index);
+            // a new component has no children yet, so its world transform is computed right away
+            {
+                std::shared_lock<std::shared_mutex> hierarchy_lock(hierarchy_mutex_);
+                computeWorldTransform(index);
+            }
 
             return index;
         }
 
+        std::vector<size_t> TransformComponentManager::addComponents(std::span<ComponentParameters const> components)
+        {
+            std::vector<size_t> indices;
+
+            // new components are roots, i.e. link to themselves and their world transform is the local transform
+            data_.addComponents(components.size(),
+                [&components](size_t i, size_t index) {
+                    auto const& cmp = components[i];
+                    return std::make_tuple(
+                        cmp.entity,
+                        computeLocalTransform(cmp.position, cmp.orientation, cmp.scale),
+                        cmp.position,
+                        cmp.orientation,
+                        cmp.scale,
+                        index,
+                        index,
+                        index);
+                },
+                indices
+            );
+
+            std::vector<unsigned int> entity_ids;
+            entity_ids.reserve(components.size());
+            for (auto const& cmp : components) {
+                entity_ids.push_back(cmp.entity.id());
+            }
+
+            addIndices(entity_ids, indices);
+
+            return indices;
+        }
+
+        void TransformComponentManager::recordAddComponent(Entity entity, Vec3 position, Quat orientation, Vec3 scale)
+        {
+            recorded_additions_.record({ entity, position, orientation, scale });
+        }
+
+        void TransformComponentManager::recordDeleteComponent(Entity entity)
+        {
+            recorded_removals_.record(entity);
+        }
+
+        void TransformComponentManager::applyCommandBuffers()
+        {
+            std::vector<ComponentParameters> additions;
+            recorded_additions_.take(additions);
+
+            if (!additions.empty()) {
+                addComponents(additions);
+            }
+
+            // removals go last, so that a component added and removed within the same frame is gone
+            std::vector<Entity> removals;
+            recorded_removals_.take(removals);
+
+            if (!removals.empty()) {
+                deleteComponents(removals);
+            }
+        }
+
         void TransformComponentManager::deleteComponent(Entity entity)
         {
             auto query = getIndex(entity);
 
+            if (query == Utility::SingleInstanceIndexMap::invalid_index) {
+                return;
+            }
+
+            std::vector<size_t> orphaned_children;
+
+            // unlinking writes to the parent, siblings and children, which can live on any page
+            std::unique_lock<std::shared_mutex> hierarchy_lock(hierarchy_mutex_);
+
+            {
+                auto [page_idx, idx_in_page] = data_.getIndices(query);
+
+                auto lock = data_.accquirePageLock(page_idx);
+
+                size_t parent_idx = data_.get<PARENT>(page_idx, idx_in_page);
+                size_t next_sibling_idx = data_.get<NEXT_SIBLING>(page_idx, idx_in_page);
+
+                // take the component out of its parent's list of children, the last sibling links to itself
+                if (parent_idx != query)
+                {
+                    auto [parent_page_idx, parent_idx_in_page] = data_.getIndices(parent_idx);
+
+                    if (data_.get<FIRST_CHILD>(parent_page_idx, parent_idx_in_page) == query)
+                    {
+                        data_.get<FIRST_CHILD>(parent_page_idx, parent_idx_in_page) = (next_sibling_idx != query) ? next_sibling_idx : parent_idx;
+                    }
+                    else
+                    {
+                        size_t child_idx = data_.get<FIRST_CHILD>(parent_page_idx, parent_idx_in_page);
+                        auto [child_page_idx, child_idx_in_page] = data_.getIndices(child_idx);
+
+                        while (data_.get<NEXT_SIBLING>(child_page_idx, child_idx_in_page) != query)
+                        {
+                            child_idx = data_.get<NEXT_SIBLING>(child_page_idx, child_idx_in_page);
+                            std::tie(child_page_idx, child_idx_in_page) = data_.getIndices(child_idx);
+                        }
+
+                        data_.get<NEXT_SIBLING>(child_page_idx, child_idx_in_page) = (next_sibling_idx != query) ? next_sibling_idx : child_idx;
+                    }
+                }
+
+                // orphaned children become roots
+                size_t child_idx = data_.get<FIRST_CHILD>(page_idx, idx_in_page);
+
+                while (child_idx != query)
+                {
+                    auto [child_page_idx, child_idx_in_page] = data_.getIndices(child_idx);
+
+                    size_t next_child_idx = data_.get<NEXT_SIBLING>(child_page_idx, child_idx_in_page);
+
+                    data_.get<PARENT>(child_page_idx, child_idx_in_page) = child_idx;
+                    data_.get<NEXT_SIBLING>(child_page_idx, child_idx_in_page) = child_idx;
+
+                    orphaned_children.push_back(child_idx);
+
+                    child_idx = (next_child_idx != child_idx) ? next_child_idx : query;
+                }
+            }
+
             data_.deleteComponent(query);
+            removeIndex(entity.id());
+
+            hierarchy_lock.unlock();
+
+            // the local transform of orphaned children now is their world transform
+            for (auto child_idx : orphaned_children) {
+                markDirty(child_idx);
+            }
+        }
+
+        void TransformComponentManager::deleteComponents(std::span<Entity const> entities)
+        {
+            for (auto entity : entities) {
+                deleteComponent(entity);
+            }
         }
 
         size_t TransformComponentManager::getComponentCount() const
@@ -69,10 +221,10 @@ namespace EngineCore
 
                 auto lock = data_.accquirePageLock(page_idx);
 
-                data_(page_idx, idx_in_page).position += translation;
+                data_.get<POSITION>(page_idx, idx_in_page) += translation;
             }
 
-            transform(index);
+            markDirty(index);
         }
 
         void TransformComponentManager::rotate(size_t index, Quat rotation)
@@ -82,10 +234,10 @@ namespace EngineCore
 
                 auto lock = data_.accquirePageLock(page_idx);
 
-                data_(page_idx, idx_in_page).orientation = glm::normalize(rotation * data_(page_idx, idx_in_page).orientation);
+                data_.get<ORIENTATION>(page_idx, idx_in_page) = glm::normalize(rotation * data_.get<ORIENTATION>(page_idx, idx_in_page));
             }
 
-            transform(index);
+            markDirty(index);
         }
 
         void TransformComponentManager::rotateLocal(size_t index, Quat rotation)
@@ -95,10 +247,10 @@ namespace EngineCore
 
                 auto lock = data_.accquirePageLock(page_idx);
 
-                data_(page_idx, idx_in_page).orientation = glm::normalize(data_(page_idx, idx_in_page).orientation * rotation);
+                data_.get<ORIENTATION>(page_idx, idx_in_page) = glm::normalize(data_.get<ORIENTATION>(page_idx, idx_in_page) * rotation);
             }
 
-            transform(index);
+            markDirty(index);
         }
 
         void TransformComponentManager::scale(size_t index, Vec3 scale_factors)
@@ -108,58 +260,144 @@ namespace EngineCore
 
                 auto lock = data_.accquirePageLock(page_idx);
 
-                data_(page_idx, idx_in_page).scale *= scale_factors;
+                data_.get<SCALE>(page_idx, idx_in_page) *= scale_factors;
             }
 
-            transform(index);
+            markDirty(index);
         }
 
-        void TransformComponentManager::transform(size_t index)
+        void TransformComponentManager::computeWorldTransform(size_t index)
         {
             auto [page_idx, idx_in_page] = data_.getIndices(index);
 
             auto lock = data_.accquirePageLock(page_idx);
 
-            Mat4x4 xform = glm::toMat4(data_(page_idx, idx_in_page).orientation);
-            xform[3] = Vec4(data_(page_idx, idx_in_page).position, 1.0);
-            xform[0] *= data_(page_idx, idx_in_page).scale.x;
-            xform[1] *= data_(page_idx, idx_in_page).scale.y;
-            xform[2] *= data_(page_idx, idx_in_page).scale.z;
+            Mat4x4 xform = computeLocalTransform(
+                data_.get<POSITION>(page_idx, idx_in_page),
+                data_.get<ORIENTATION>(page_idx, idx_in_page),
+                data_.get<SCALE>(page_idx, idx_in_page));
 
-            if (data_(page_idx, idx_in_page).parent != index) {
-                auto [parent_page_idx, parent_idx_in_page] = data_.getIndices(data_(page_idx, idx_in_page).parent);
-                data_(page_idx, idx_in_page).world_transform = data_(parent_page_idx, parent_idx_in_page).world_transform * xform;
+            if (data_.get<PARENT>(page_idx, idx_in_page) != index) {
+                auto [parent_page_idx, parent_idx_in_page] = data_.getIndices(data_.get<PARENT>(page_idx, idx_in_page));
+                data_.get<WORLD_TRANSFORM>(page_idx, idx_in_page) = data_.get<WORLD_TRANSFORM>(parent_page_idx, parent_idx_in_page) * xform;
             }
             else {
-                data_(page_idx, idx_in_page).world_transform = xform;
+                data_.get<WORLD_TRANSFORM>(page_idx, idx_in_page) = xform;
             }
 
-            // update transforms of all children
-            size_t child_idx = data_(page_idx, idx_in_page).first_child;
-            if (child_idx != index)
+            data_.markChanged(page_idx, idx_in_page);
+        }
+
+        void TransformComponentManager::computeSubtreeWorldTransforms(std::vector<size_t>& update_order)
+        {
+            // walk the subtrees breadth first, i.e. each component is computed once and after its parent
+            for (size_t i = 0; i < update_order.size(); ++i)
             {
-                lock.unlock();
-                transform(child_idx);
-                lock.lock();
+                size_t index = update_order[i];
 
-                auto [child_page_idx, child_idx_in_page] = data_.getIndices(child_idx);
-                size_t sibling_idx = data_(child_page_idx, child_idx_in_page).next_sibling;
+                computeWorldTransform(index);
 
-                while (sibling_idx != child_idx)
+                size_t child_idx;
                 {
-                    auto [sibling_page_idx, sibing_idx_in_page] = data_.getIndices(sibling_idx);
+                    auto [page_idx, idx_in_page] = data_.getIndices(index);
+                    auto lock = data_.accquirePageLock(page_idx);
+                    child_idx = data_.get<FIRST_CHILD>(page_idx, idx_in_page);
+                }
+
+                if (child_idx == index) {
+                    continue;
+                }
+
+                // the last sibling links to itself
+                while (true)
+                {
+                    update_order.push_back(child_idx);
+
+                    auto [child_page_idx, child_idx_in_page] = data_.getIndices(child_idx);
+                    auto lock = data_.accquirePageLock(child_page_idx);
+
+                    size_t sibling_idx = data_.get<NEXT_SIBLING>(child_page_idx, child_idx_in_page);
+                    if (sibling_idx == child_idx) {
+                        break;
+                    }
 
                     child_idx = sibling_idx;
-                    child_page_idx = sibling_page_idx;
-                    child_idx_in_page = sibing_idx_in_page;
+                }
+            }
+        }
 
-                    lock.unlock();
-                    transform(child_idx);
-                    lock.lock();
+        void TransformComponentManager::markDirty(size_t index)
+        {
+            if (propagation_ == Propagation::DEFERRED)
+            {
+                dirty_components_.record(index);
+                return;
+            }
+
+            updateWorldTransforms(index);
+        }
+
+        void TransformComponentManager::updateWorldTransforms()
+        {
+            std::vector<size_t> dirty_indices;
+            dirty_components_.take(dirty_indices);
+
+            if (dirty_indices.empty()) {
+                return;
+            }
+
+            // components changed several times are updated once, deleted components not at all
+            std::sort(dirty_indices.begin(), dirty_indices.end());
+            dirty_indices.erase(std::unique(dirty_indices.begin(), dirty_indices.end()), dirty_indices.end());
+            dirty_indices.erase(std::remove_if(dirty_indices.begin(), dirty_indices.end(), [this](size_t index) {
+                auto [page_idx, idx_in_page] = data_.getIndices(index);
+                return !data_.checkComponent(page_idx, idx_in_page);
+            }), dirty_indices.end());
 
-                    sibling_idx = data_(child_page_idx, child_idx_in_page).next_sibling;
+            std::shared_lock<std::shared_mutex> hierarchy_lock(hierarchy_mutex_);
+
+            auto getParentIndex = [this](size_t index) {
+                auto [page_idx, idx_in_page] = data_.getIndices(index);
+                auto lock = data_.accquirePageLock(page_idx);
+                return data_.get<PARENT>(page_idx, idx_in_page);
+            };
+
+            // a dirty component below another dirty component is updated as part of that component's subtree
+            std::vector<size_t> update_order;
+            update_order.reserve(dirty_indices.size());
+
+            for (auto index : dirty_indices)
+            {
+                size_t current_idx = index;
+                size_t parent_idx = getParentIndex(index);
+                bool covered = false;
+
+                while (parent_idx != current_idx && !covered)
+                {
+                    covered = std::binary_search(dirty_indices.begin(), dirty_indices.end(), parent_idx);
+                    current_idx = parent_idx;
+                    parent_idx = getParentIndex(current_idx);
+                }
+
+                if (!covered) {
+                    update_order.push_back(index);
                 }
             }
+
+            computeSubtreeWorldTransforms(update_order);
+        }
+
+        void TransformComponentManager::updateWorldTransforms(size_t index)
+        {
+            std::shared_lock<std::shared_mutex> hierarchy_lock(hierarchy_mutex_);
+
+            std::vector<size_t> update_order = { index };
+            computeSubtreeWorldTransforms(update_order);
+        }
+
+        void TransformComponentManager::propagateChanges()
+        {
+            updateWorldTransforms();
         }
 
         void TransformComponentManager::setPosition(Entity entity, Vec3 position)
@@ -176,10 +414,10 @@ namespace EngineCore
 
                 auto lock = data_.accquirePageLock(page_idx);
 
-                data_(page_idx, idx_in_page).position = position;
+                data_.get<POSITION>(page_idx, idx_in_page) = position;
             }
 
-            transform(index);
+            markDirty(index);
         }
 
         void TransformComponentManager::setOrientation(size_t index, Quat orientation)
@@ -189,10 +427,10 @@ namespace EngineCore
 
                 auto lock = data_.accquirePageLock(page_idx);
 
-                data_(page_idx, idx_in_page).orientation = orientation;
+                data_.get<ORIENTATION>(page_idx, idx_in_page) = orientation;
             }
 
-            transform(index);
+            markDirty(index);
         }
 
         void TransformComponentManager::setScale(size_t index, Vec3 scale)
@@ -202,15 +440,18 @@ namespace EngineCore
 
                 auto lock = data_.accquirePageLock(page_idx);
 
-                data_(page_idx, idx_in_page).scale = scale;
+                data_.get<SCALE>(page_idx, idx_in_page) = scale;
             }
 
-            transform(index);
+            markDirty(index);
         }
 
         void TransformComponentManager::setParent(size_t index, Entity parent)
         {
             {
+                // linking writes to the parent's and the last sibling's page as well
+                std::unique_lock<std::shared_mutex> hierarchy_lock(hierarchy_mutex_);
+
                 auto [page_idx, idx_in_page] = data_.getIndices(index);
 
                 auto lock = data_.accquirePageLock(page_idx);
@@ -218,31 +459,30 @@ namespace EngineCore
                 auto query = getIndex(parent);
 
                 size_t parent_idx = query;
-                data_(page_idx, idx_in_page).parent = parent_idx;
+                data_.get<PARENT>(page_idx, idx_in_page) = parent_idx;
 
                 auto [parent_page_idx, parent_idx_in_page] = data_.getIndices(parent_idx);
 
-                if (data_(parent_page_idx, parent_idx_in_page).first_child == parent_idx)
+                if (data_.get<FIRST_CHILD>(parent_page_idx, parent_idx_in_page) == parent_idx)
                 {
-                    data_(parent_page_idx, parent_idx_in_page).first_child = index;
+                    data_.get<FIRST_CHILD>(parent_page_idx, parent_idx_in_page) = index;
                 }
                 else
                 {
-                    size_t child_idx = data_(parent_page_idx, parent_idx_in_page).first_child;
+                    size_t child_idx = data_.get<FIRST_CHILD>(parent_page_idx, parent_idx_in_page);
                     auto [child_page_idx, child_idx_in_page] = data_.getIndices(child_idx);
 
-                    while (data_(child_page_idx, child_idx_in_page).next_sibling != child_idx)
+                    while (data_.get<NEXT_SIBLING>(child_page_idx, child_idx_in_page) != child_idx)
                     {
-                        child_idx = data_(child_page_idx, child_idx_in_page).next_sibling;
+                        child_idx = data_.get<NEXT_SIBLING>(child_page_idx, child_idx_in_page);
                         std::tie(child_page_idx, child_idx_in_page) = data_.getIndices(child_idx);
                     }
 
-                    data_(child_page_idx, child_idx_in_page).next_sibling = index;
+                    data_.get<NEXT_SIBLING>(child_page_idx, child_idx_in_page) = index;
                 }
             }
 
-            transform(index);
-
+            markDirty(index);
         }
 
         Vec3 const& TransformComponentManager::getPosition(size_t index) const
@@ -251,7 +491,7 @@ namespace EngineCore
 
             auto lock = data_.accquirePageLock(page_idx);
 
-            return data_(page_idx, idx_in_page).position;
+            return data_.get<POSITION>(page_idx, idx_in_page);
         }
 
         Vec3 TransformComponentManager::getWorldPosition(size_t index) const
@@ -260,7 +500,7 @@ namespace EngineCore
 
             auto lock = data_.accquirePageLock(page_idx);
 
-            return Vec3(data_(page_idx, idx_in_page).world_transform * Vec4(0.0f, 0.0f, 0.0f, 1.0f));
+            return Vec3(data_.get<WORLD_TRANSFORM>(page_idx, idx_in_page) * Vec4(0.0f, 0.0f, 0.0f, 1.0f));
         }
 
         Vec3 TransformComponentManager::getWorldPosition(Entity e) const
@@ -280,7 +520,7 @@ namespace EngineCore
 
             auto lock = data_.accquirePageLock(page_idx);
 
-            return data_(page_idx, idx_in_page).orientation;
+            return data_.get<ORIENTATION>(page_idx, idx_in_page);
         }
 
         Mat4x4 const& TransformComponentManager::getWorldTransformation(size_t index) const
@@ -289,7 +529,7 @@ namespace EngineCore
 
             auto lock = data_.accquirePageLock(page_idx);
 
-            return data_(page_idx, idx_in_page).world_transform;
+            return data_.get<WORLD_TRANSFORM>(page_idx, idx_in_page);
         }
 
         std::vector<Entity> TransformComponentManager::getChildren(Entity entity) const
@@ -307,18 +547,20 @@ namespace EngineCore
         {
             std::vector<Entity> retval;
 
+            std::shared_lock<std::shared_mutex> hierarchy_lock(hierarchy_mutex_);
+
             auto [page_idx, idx_in_page] = data_.getIndices(index);
 
             auto lock = data_.accquirePageLock(page_idx);
 
-            size_t child_idx = data_(page_idx, idx_in_page).first_child;
+            size_t child_idx = data_.get<FIRST_CHILD>(page_idx, idx_in_page);
             if (child_idx != index)
             {
                 auto [child_page_idx, child_idx_in_page] = data_.getIndices(child_idx);
 
-                retval.push_back(data_(child_page_idx, child_idx_in_page).entity);
+                retval.push_back(data_.get<ENTITY>(child_page_idx, child_idx_in_page));
 
-                size_t sibling_idx = data_(child_page_idx, child_idx_in_page).next_sibling;
+                size_t sibling_idx = data_.get<NEXT_SIBLING>(child_page_idx, child_idx_in_page);
 
                 while (sibling_idx != child_idx)
                 {
@@ -328,9 +570,9 @@ namespace EngineCore
                     child_page_idx = sibling_page_idx;
                     child_idx_in_page = sibing_idx_in_page;
 
-                    retval.push_back(data_(child_page_idx, child_idx_in_page).entity);
+                    retval.push_back(data_.get<ENTITY>(child_page_idx, child_idx_in_page));
 
-                    sibling_idx = data_(child_page_idx, child_idx_in_page).next_sibling;
+                    sibling_idx = data_.get<NEXT_SIBLING>(child_page_idx, child_idx_in_page);
                 }
             }
 
@@ -341,19 +583,38 @@ namespace EngineCore
         {
             Entity retval;
 
+            std::shared_lock<std::shared_mutex> hierarchy_lock(hierarchy_mutex_);
+
             auto [page_idx, idx_in_page] = data_.getIndices(index);
 
             auto lock = data_.accquirePageLock(page_idx);
 
-            size_t parent_idx = data_(page_idx, idx_in_page).parent;
+            size_t parent_idx = data_.get<PARENT>(page_idx, idx_in_page);
 
             if (parent_idx != index)
             {
                 auto [parent_page_idx, parent_idx_in_page] = data_.getIndices(parent_idx);
-                retval = data_(parent_page_idx, parent_idx_in_page).entity;
+                retval = data_.get<ENTITY>(parent_page_idx, parent_idx_in_page);
             }
 
             return retval;
         }
+
+        uint64_t TransformComponentManager::advanceChangeVersion()
+        {
+            return data_.advanceVersion();
+        }
+
+        uint64_t TransformComponentManager::getChangeVersion(size_t index) const
+        {
+            auto [page_idx, idx_in_page] = data_.getIndices(index);
+
+            return data_.getChangeVersion(page_idx, idx_in_page);
+        }
+
+        size_t TransformComponentManager::getComponentPageCount() const
+        {
+            return data_.getUsedPageCount();
+        }
     }
 }
\ No newline at end of file
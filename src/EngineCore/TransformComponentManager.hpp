@@ -3,14 +3,16 @@
 
 // space-lion includes
 #include "BaseSingleInstanceComponentManager.hpp"
-#include "ComponentStorage.hpp"
+#include "CommandBuffer.hpp"
 #include "EntityManager.hpp"
+#include "SoAComponentStorage.hpp"
 #include "types.hpp"
 
 // std includes
 #include <unordered_map>
 #include <iostream>
 #include <shared_mutex>
+#include <vector>
 
 namespace EngineCore
 {
@@ -18,33 +20,130 @@ namespace EngineCore
     {
         class TransformComponentManager : public BaseSingleInstanceComponentManager
         {
+        private:
+            /** Component fields, stored as one array per field (see data_) */
+            enum Field : size_t
+            {
+                ENTITY,          ///< entity that owns the component
+                WORLD_TRANSFORM, ///< the actual transformation (aka model matrix)
+                POSITION,        ///< local position (equals global position if component has no parent)
+                ORIENTATION,     ///< local orientation (...)
+                SCALE,           ///< local scale (...)
+                PARENT,          ///< index to parent (equals components own index if comp. has no parent)
+                FIRST_CHILD,     ///< index to child (...)
+                NEXT_SIBLING     ///< index to sibling (...)
+            };
+
+            /** Struct-of-arrays layout, passes that only read world transforms don't pull the hierarchy links through the cache */
+            Utility::SoAComponentStorage<100000, 1000, Entity, Mat4x4, Vec3, Quat, Vec3, size_t, size_t, size_t> data_;
+
+            /**
+             * Guards the PARENT, FIRST_CHILD and NEXT_SIBLING links, which connect components on different pages.
+             * Edits of the hierarchy lock it exclusively, walks along the links lock it shared. Taken before any page lock.
+             */
+            mutable std::shared_mutex hierarchy_mutex_;
+
+            /**
+             * Recompute the world transform of a single component from its local transform and its parent's world transform.
+             * The hierarchy has to be locked (at least shared).
+             */
+            void computeWorldTransform(size_t index);
+
+            /**
+             * Recompute the world transforms of the given components and all their descendants, parents before children.
+             * Descendants are appended to update_order. The hierarchy has to be locked (at least shared).
+             */
+            void computeSubtreeWorldTransforms(std::vector<size_t>& update_order);
+
+            /**
+             * Update the world transforms of the component and its descendants right away or, with deferred propagation,
+             * mark it for the next updateWorldTransforms. The hierarchy must not be locked by the caller.
+             */
+            void markDirty(size_t index);
+
+            /** Components whose local transform or parent changed since the last update, recorded without contention */
+            Utility::CommandBuffer<size_t> dirty_components_;
+
         public:
-            struct Data
+            /** When setters update the world transforms of the changed components and their descendants */
+            enum class Propagation
             {
-                Entity entity;          ///< entity that owns the component
-                Mat4x4 world_transform; ///< the actual transformation (aka model matrix)
-                Vec3 position;          ///< local position (equals global position if component has no parent)
-                Quat orientation;       ///< local orientation (...)
-                Vec3 scale;             ///< local scale (...)
-
-                size_t parent;          ///< index to parent (equals components own index if comp. has no parent)
-                size_t first_child;     ///< index to child (...)
-                size_t next_sibling;    ///< index to sibling (...)
+                IMMEDIATE, ///< right away, in every setter call
+                DEFERRED   ///< once per frame in propagateChanges, world transforms keep their previous value until then
             };
+
         private:
+            Propagation const propagation_;
 
-            Utility::ComponentStorage<Data, 100000, 1000> data_;
+        public:
+            /** Initial state of a component, for bulk and recorded additions */
+            struct ComponentParameters
+            {
+                Entity entity;
+                Vec3   position = Vec3();
+                Quat   orientation = Quat();
+                Vec3   scale = Vec3(1.0);
+            };
 
-            void transform(size_t index);
+        private:
+            /** Additions and removals recorded from systems and loaders, applied in bulk by applyCommandBuffers */
+            Utility::CommandBuffer<ComponentParameters> recorded_additions_;
+            Utility::CommandBuffer<Entity>              recorded_removals_;
 
         public:
-            TransformComponentManager();
+            /**
+             * Use Propagation::DEFERRED only if the frame loop calls propagateChanges (see WorldState::runSystems) once per frame.
+             */
+            explicit TransformComponentManager(Propagation propagation = Propagation::IMMEDIATE);
             ~TransformComponentManager();
 
             size_t addComponent(Entity entity, Vec3 position = Vec3(), Quat orientation = Quat(), Vec3 scale = Vec3(1.0));
 
+            /**
+             * Add several root components at once, reserving their slots in bulk.
+             * \return Returns the component indices, in order of the given components.
+             */
+            std::vector<size_t> addComponents(std::span<ComponentParameters const> components);
+
+            /**
+             * Record the addition of a component from any thread without contention. The component is added by the next applyCommandBuffers.
+             */
+            void recordAddComponent(Entity entity, Vec3 position = Vec3(), Quat orientation = Quat(), Vec3 scale = Vec3(1.0));
+
+            /**
+             * Record the removal of a component from any thread without contention. The component is removed by the next applyCommandBuffers.
+             */
+            void recordDeleteComponent(Entity entity);
+
+            void applyCommandBuffers() override;
+
+            /**
+             * Delete the entity's component. The entity is taken out of its parent's children,
+             * its children become roots (keeping their local transforms).
+             */
             void deleteComponent(Entity entity);
 
+            void deleteComponents(std::span<Entity const> entities) override;
+
+            /**
+             * Recompute the world transforms of all components marked dirty since the last call, including their descendants.
+             * A component that changed several times is recomputed once, in a single pass that visits parents before their children.
+             * Changes made by setters running concurrently are picked up by this or the next call.
+             */
+            void updateWorldTransforms();
+
+            /**
+             * Recompute the world transforms of the component and its descendants right away,
+             * for readers that need the changed values before the next propagateChanges.
+             */
+            void updateWorldTransforms(size_t index);
+
+            /**
+             * Update the world transforms of all components changed since the last call, see updateWorldTransforms.
+             * Only needed with deferred propagation.
+             */
+            void propagateChanges() override;
+
             size_t getComponentCount() const;
 
             void translate(Entity entity, Vec3 translation);
@@ -82,6 +181,31 @@ namespace EngineCore
             std::vector<Entity> getChildren(size_t index) const;
 
             Entity getParent(size_t index) const;
+
+            /**
+             * Close the current change version of the world transformations, see SoAComponentStorage::advanceVersion.
+             * \return Returns the closed version, for the consumer's next change query.
+             */
+            uint64_t advanceChangeVersion();
+
+            /**
+             * Version of the last change of the component's world transformation.
+             */
+            uint64_t getChangeVersion(size_t index) const;
+
+            /** Number of component pages, i.e. the page range for forEachChangedSince */
+            size_t getComponentPageCount() const;
+
+            /**
+             * Call fn(index) for every component in the pages [page_begin, page_end) whose world transformation
+             * changed after the given version. Disjoint page ranges can be processed concurrently.
+             */
+            template<typename Function>
+            void forEachChangedSince(uint64_t version, size_t page_begin, size_t page_end, Function&& fn) const
+            {
+                data_.forEachChangedSince(version, page_begin, page_end,
+                    [&fn](size_t index, size_t, size_t) { fn(index); });
+            }
         };
     }
 }
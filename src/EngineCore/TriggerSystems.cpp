@@ -1,45 +1,56 @@
 #include "TriggerSystems.hpp"
 
+#include "WorldState.hpp"
+
 void EngineCore::Common::checkProximityTriggers(
     EngineCore::Common::TransformComponentManager& transform_mngr,
     EngineCore::Common::ProximityTriggerComponentManager& proximity_trigger_mngr,
     double dt,
     Utility::TaskScheduler& task_scheduler)
 {
-    size_t component_cnt = proximity_trigger_mngr.getComponentCount();
-
-    std::vector<std::pair<size_t, size_t>> from_to_pairs;
-    size_t bucket_cnt = 6;
-    for (size_t i = 0; i < bucket_cnt; ++i) {
-        from_to_pairs.push_back({ component_cnt * (float(i) / float(bucket_cnt)), component_cnt * (float(i + 1) / float(bucket_cnt)) });
-    }
-
-    for (auto from_to : from_to_pairs) {
-        task_scheduler.submitTask(
-            [&transform_mngr, &proximity_trigger_mngr, from_to, dt]() {
-                for (size_t i = from_to.first; i < from_to.second; ++i)
-                {
-                    if (proximity_trigger_mngr.checkComponent(i)) {
-                        auto& cmp = proximity_trigger_mngr.getComponent(i);
-
-                        auto entity_transform_idx = transform_mngr.getIndex(cmp.entity);
-                        auto target_transform_idx = transform_mngr.getIndex(cmp.target);
-
-                        float distance = glm::length(transform_mngr.getWorldPosition(entity_transform_idx) - transform_mngr.getWorldPosition(target_transform_idx));
-
-                        if (distance < cmp.trigger_distance && !cmp.in_proximity) {
-                            cmp.enter_callback();
-                            cmp.in_proximity = true;
-                        }
-                        else if (distance > cmp.trigger_distance && cmp.in_proximity) {
-                            cmp.leave_callback();
-                            cmp.in_proximity = false;
-                        }
+    size_t page_cnt = proximity_trigger_mngr.getComponentPageCount();
+
+    // transforms changed after this version are checked in the next call
+    uint64_t transform_version = transform_mngr.advanceChangeVersion();
+
+    // parallelize over component pages, each page only visits its live components
+    task_scheduler.parallelFor(0, page_cnt,
+        [&transform_mngr, &proximity_trigger_mngr, transform_version, dt](size_t from, size_t to) {
+            proximity_trigger_mngr.forEachComponent(from, to,
+                [&transform_mngr, transform_version](size_t, auto& cmp) {
+                    auto entity_transform_idx = transform_mngr.getIndex(cmp.entity);
+                    auto target_transform_idx = transform_mngr.getIndex(cmp.target);
+
+                    // the distance can only change if one of the two transforms changed since the last check
+                    uint64_t change_version = std::max(transform_mngr.getChangeVersion(entity_transform_idx), transform_mngr.getChangeVersion(target_transform_idx));
+                    if (change_version <= cmp.checked_version) {
+                        return;
+                    }
+                    cmp.checked_version = transform_version;
+
+                    float distance = glm::length(transform_mngr.getWorldPosition(entity_transform_idx) - transform_mngr.getWorldPosition(target_transform_idx));
+
+                    if (distance < cmp.trigger_distance && !cmp.in_proximity) {
+                        cmp.enter_callback();
+                        cmp.in_proximity = true;
+                    }
+                    else if (distance > cmp.trigger_distance && cmp.in_proximity) {
+                        cmp.leave_callback();
+                        cmp.in_proximity = false;
                     }
                 }
-            }
-        );
-    }
+            );
+        },
+        1
+    );
+}
 
-    task_scheduler.waitWhileBusy();
+void EngineCore::Common::addTriggerSystems(WorldState& world)
+{
+    // only the trigger state is written, closing the transform change version is safe for readers
+    world.add<Reads<TransformComponentManager>, Writes<ProximityTriggerComponentManager>>(
+        [](WorldState& world, double dt, Utility::TaskScheduler& task_scheduler) {
+            checkProximityTriggers(world.get<TransformComponentManager>(), world.get<ProximityTriggerComponentManager>(), dt, task_scheduler);
+        }
+    );
 }
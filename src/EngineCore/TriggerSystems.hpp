@@ -6,12 +6,21 @@
 #include "TransformComponentManager.hpp"
 
 namespace EngineCore {
+
+class WorldState;
+
 namespace Common {
     void checkProximityTriggers(
         EngineCore::Common::TransformComponentManager& transform_mngr,
         EngineCore::Common::ProximityTriggerComponentManager& proximity_trigger_mngr,
         double dt,
         Utility::TaskScheduler& task_scheduler);
+
+    /**
+     * Add the proximity trigger system to the world, declaring the component managers it reads and writes
+     * (see WorldState::runSystems).
+     */
+    void addTriggerSystems(WorldState& world);
 }
 }
 
@@ -7,13 +7,20 @@
 
 void EngineCore::Animation::TurntableComponentManager::addComponent(Entity entity, float angle, Vec3 axis)
 {
-    std::unique_lock<std::shared_mutex> lock(m_dataAccess_mutex);
+    m_data.modify([this, entity, angle, axis](std::vector<Data>& data) {
+        uint idx = static_cast<uint>(data.size());
 
-    uint idx = static_cast<uint>(m_data.size());
+        addIndex(entity.id(), idx);
 
-    addIndex(entity.id(), idx);
+        data.push_back(Data(entity, angle, axis));
+    });
+}
 
-    m_data.push_back(Data(entity, angle, axis));
+void EngineCore::Animation::TurntableComponentManager::deleteComponents(std::span<Entity const> entities)
+{
+    m_data.modify([this, entities](std::vector<Data>& data) {
+        eraseComponents(entities, data);
+    });
 }
 
 //void EngineCore::Animation::TurntableComponentManager::animate(double dt)
@@ -34,15 +41,7 @@ void EngineCore::Animation::TurntableComponentManager::addComponent(Entity entit
 //    }
 //}
 
-std::vector<EngineCore::Animation::TurntableComponentManager::Data> EngineCore::Animation::TurntableComponentManager::getComponentDataCopy()
+EngineCore::Utility::SnapshotVector<EngineCore::Animation::TurntableComponentManager::Data>::Snapshot EngineCore::Animation::TurntableComponentManager::getComponentDataSnapshot() const
 {
-    std::vector<EngineCore::Animation::TurntableComponentManager::Data> retval;
-
-    {
-        std::shared_lock<std::shared_mutex> lock(m_dataAccess_mutex);
-
-        retval = m_data;
-    }
-
-    return retval;
+    return m_data.getSnapshot();
 }
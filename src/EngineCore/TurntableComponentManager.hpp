@@ -8,6 +8,7 @@
 
 #include "BaseSingleInstanceComponentManager.hpp"
 #include "EntityManager.hpp"
+#include "SnapshotVector.hpp"
 
 namespace EngineCore
 {
@@ -28,8 +29,7 @@ namespace EngineCore
                 Vec3   axis;
             };
         private:
-            std::vector<Data> m_data;
-            std::shared_mutex m_dataAccess_mutex;
+            Utility::SnapshotVector<Data> m_data;
             
         public:
             TurntableComponentManager() = default;
@@ -37,7 +37,12 @@ namespace EngineCore
 
             void addComponent(Entity entity, float angle, Vec3 axis = Vec3(0.0f,1.0f,0.0f));
 
-            std::vector<Data> getComponentDataCopy();
+            void deleteComponents(std::span<Entity const> entities) override;
+
+            /**
+             * Immutable snapshot of all components, only copied if components were added since the last snapshot.
+             */
+            Utility::SnapshotVector<Data>::Snapshot getComponentDataSnapshot() const;
         };
     }
 }
@@ -0,0 +1,204 @@
+#ifndef WorkStealingDeque_hpp
+#define WorkStealingDeque_hpp
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+namespace EngineCore
+{
+    namespace Utility
+    {
+
+        /**
+         * Lock-free single-producer, multi-consumer deque for work stealing
+         * (Chase-Lev deque, see "Correct and Efficient Work-Stealing for Weak Memory Models", Le et al. 2013).
+         * Only the owning thread may call push and pop, which operate on the bottom end (LIFO).
+         * Any thread may call steal, which operates on the top end (FIFO).
+         * Element type is restricted to trivially copyable types (e.g. pointers).
+         */
+        template <typename T>
+        class WorkStealingDeque
+        {
+            static_assert(std::is_trivially_copyable<T>::value, "WorkStealingDeque requires trivially copyable elements");
+
+        public:
+            explicit WorkStealingDeque(size_t initial_capacity = 1024);
+            ~WorkStealingDeque();
+
+            WorkStealingDeque(WorkStealingDeque const& cpy) = delete;
+            WorkStealingDeque& operator=(WorkStealingDeque const& rhs) = delete;
+
+            /**
+             * Push element to the bottom of the deque. Only to be called by the owning thread.
+             */
+            void push(T item);
+
+            /**
+             * Pop element from the bottom of the deque. Only to be called by the owning thread.
+             * \return Returns true if an element was extracted.
+             */
+            bool pop(T& item);
+
+            /**
+             * Steal element from the top of the deque. Can be called by any thread.
+             * \return Returns true if an element was extracted. Might fail spuriously under contention.
+             */
+            bool steal(T& item);
+
+            /**
+             * Approximate number of elements, only exact if called by the owning thread.
+             */
+            size_t size() const;
+
+            bool empty() const;
+
+        private:
+            struct Array
+            {
+                explicit Array(int64_t capacity)
+                    : capacity(capacity), mask(capacity - 1), storage(new std::atomic<T>[capacity]) {}
+
+                T get(int64_t i) const { return storage[i & mask].load(std::memory_order_relaxed); }
+
+                void put(int64_t i, T item) { storage[i & mask].store(item, std::memory_order_relaxed); }
+
+                int64_t                        capacity;
+                int64_t                        mask;
+                std::unique_ptr<std::atomic<T>[]> storage;
+            };
+
+            Array* grow(Array* array, int64_t bottom, int64_t top);
+
+            alignas(64) std::atomic<int64_t> top_;
+            alignas(64) std::atomic<int64_t> bottom_;
+            alignas(64) std::atomic<Array*>  array_;
+
+            /** Arrays replaced by grow, kept alive until destruction because thieves might still read from them */
+            std::vector<std::unique_ptr<Array>> retired_arrays_;
+        };
+
+        template<typename T>
+        inline WorkStealingDeque<T>::WorkStealingDeque(size_t initial_capacity)
+            : top_(0), bottom_(0)
+        {
+            // round capacity up to power of two for cheap index wrap around
+            int64_t capacity = 1;
+            while (capacity < static_cast<int64_t>(initial_capacity)) {
+                capacity <<= 1;
+            }
+            array_.store(new Array(capacity), std::memory_order_relaxed);
+        }
+
+        template<typename T>
+        inline WorkStealingDeque<T>::~WorkStealingDeque()
+        {
+            delete array_.load(std::memory_order_relaxed);
+        }
+
+        template<typename T>
+        inline void WorkStealingDeque<T>::push(T item)
+        {
+            int64_t b = bottom_.load(std::memory_order_relaxed);
+            int64_t t = top_.load(std::memory_order_acquire);
+            Array* a = array_.load(std::memory_order_relaxed);
+
+            if (b - t > a->capacity - 1) {
+                a = grow(a, b, t);
+            }
+
+            a->put(b, item);
+            std::atomic_thread_fence(std::memory_order_release);
+            bottom_.store(b + 1, std::memory_order_relaxed);
+        }
+
+        template<typename T>
+        inline bool WorkStealingDeque<T>::pop(T& item)
+        {
+            int64_t b = bottom_.load(std::memory_order_relaxed) - 1;
+            Array* a = array_.load(std::memory_order_relaxed);
+            bottom_.store(b, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            int64_t t = top_.load(std::memory_order_relaxed);
+
+            bool success = false;
+
+            if (t <= b)
+            {
+                item = a->get(b);
+                success = true;
+
+                if (t == b)
+                {
+                    // last element, race against thieves
+                    if (!top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+                        success = false;
+                    }
+                    bottom_.store(b + 1, std::memory_order_relaxed);
+                }
+            }
+            else
+            {
+                bottom_.store(b + 1, std::memory_order_relaxed);
+            }
+
+            return success;
+        }
+
+        template<typename T>
+        inline bool WorkStealingDeque<T>::steal(T& item)
+        {
+            int64_t t = top_.load(std::memory_order_acquire);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            int64_t b = bottom_.load(std::memory_order_acquire);
+
+            if (t < b)
+            {
+                Array* a = array_.load(std::memory_order_acquire);
+                T candidate = a->get(t);
+
+                if (top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+                {
+                    item = candidate;
+                    return true;
+                }
+            }
+
+            return false;
+        }
+
+        template<typename T>
+        inline size_t WorkStealingDeque<T>::size() const
+        {
+            int64_t b = bottom_.load(std::memory_order_relaxed);
+            int64_t t = top_.load(std::memory_order_relaxed);
+            return static_cast<size_t>(b > t ? b - t : 0);
+        }
+
+        template<typename T>
+        inline bool WorkStealingDeque<T>::empty() const
+        {
+            return size() == 0;
+        }
+
+        template<typename T>
+        inline typename WorkStealingDeque<T>::Array* WorkStealingDeque<T>::grow(Array* array, int64_t bottom, int64_t top)
+        {
+            Array* new_array = new Array(array->capacity * 2);
+
+            for (int64_t i = top; i < bottom; ++i) {
+                new_array->put(i, array->get(i));
+            }
+
+            retired_arrays_.emplace_back(array);
+            array_.store(new_array, std::memory_order_release);
+
+            return new_array;
+        }
+
+    }
+}
+
+#endif // !WorkStealingDeque_hpp
@@ -2,7 +2,134 @@
 
 #include "GeometryBakery.hpp"
 
+#include <algorithm>
+
 namespace EngineCore
 {
     std::atomic_int WorldState::last_type_id(0);
+
+    namespace
+    {
+        bool intersect(std::vector<int> const& lhs, std::vector<int> const& rhs)
+        {
+            return std::any_of(lhs.begin(), lhs.end(), [&rhs](int type_id) {
+                return std::find(rhs.begin(), rhs.end(), type_id) != rhs.end();
+            });
+        }
+    }
+
+    void WorldState::addSystem(std::function<void(WorldState&, double, Utility::TaskScheduler&)> system, SystemAccess access)
+    {
+        size_t system_idx = m_systems.size();
+
+        // a system depends on every earlier system it has a read-write or write-write conflict with
+        for (size_t i = 0; i < system_idx; ++i)
+        {
+            auto& other = m_system_access[i];
+
+            bool conflict = access.exclusive || other.exclusive
+                || intersect(access.writes, other.writes)
+                || intersect(access.writes, other.reads)
+                || intersect(access.reads, other.writes);
+
+            if (conflict)
+            {
+                other.successors.push_back(system_idx);
+                ++access.predecessor_cnt;
+            }
+        }
+
+        m_systems.emplace_back(system);
+        m_system_access.push_back(std::move(access));
+    }
+
+    void WorldState::forEachComponentManager(Utility::TaskScheduler& task_scheduler, std::function<void(BaseComponentManager&)> const& fn)
+    {
+        std::shared_lock<std::shared_mutex> lock(m_component_access_mutex);
+
+        Utility::TaskGroup task_group;
+
+        std::vector<Utility::Task> tasks;
+        tasks.reserve(m_component_managers.size());
+        for (auto& component_mngr : m_component_managers)
+        {
+            BaseComponentManager* mngr = component_mngr.get();
+            tasks.push_back([mngr, &fn]() { fn(*mngr); });
+        }
+
+        task_scheduler.submitTasks(std::move(tasks), task_group);
+        task_scheduler.wait(task_group);
+    }
+
+    void WorldState::applyCommandBuffers(Utility::TaskScheduler& task_scheduler)
+    {
+        forEachComponentManager(task_scheduler, [](BaseComponentManager& component_mngr) {
+            component_mngr.applyCommandBuffers();
+        });
+    }
+
+    void WorldState::propagateChanges(Utility::TaskScheduler& task_scheduler)
+    {
+        forEachComponentManager(task_scheduler, [](BaseComponentManager& component_mngr) {
+            component_mngr.propagateChanges();
+        });
+    }
+
+    void WorldState::processDestroyedEntities(Utility::TaskScheduler& task_scheduler)
+    {
+        std::vector<Entity> destroyed_entities = m_entity_manager.takeDestroyedEntities();
+
+        if (destroyed_entities.empty()) {
+            return;
+        }
+
+        forEachComponentManager(task_scheduler, [&destroyed_entities](BaseComponentManager& component_mngr) {
+            component_mngr.deleteComponents(destroyed_entities);
+        });
+
+        // entities are only released once no component refers to them anymore, so their indices can't be reused too early
+        m_entity_manager.release(destroyed_entities);
+    }
+
+    void WorldState::runSystems(double dt, Utility::TaskScheduler& task_scheduler)
+    {
+        // recorded additions first, so that components added for entities destroyed in the same frame are removed as well
+        applyCommandBuffers(task_scheduler);
+        processDestroyedEntities(task_scheduler);
+
+        size_t system_cnt = m_systems.size();
+
+        std::unique_ptr<std::atomic_size_t[]> remaining_predecessors(new std::atomic_size_t[system_cnt]);
+        for (size_t i = 0; i < system_cnt; ++i) {
+            remaining_predecessors[i] = m_system_access[i].predecessor_cnt;
+        }
+
+        Utility::TaskGroup task_group;
+
+        // every finished system submits those of its successors that have no more unfinished predecessors
+        std::function<void(size_t)> run_system = [&](size_t system_idx)
+        {
+            m_systems[system_idx](*this, dt, task_scheduler);
+
+            for (auto successor_idx : m_system_access[system_idx].successors)
+            {
+                if (--remaining_predecessors[successor_idx] == 0) {
+                    task_scheduler.submitTask([&run_system, successor_idx]() { run_system(successor_idx); }, task_group);
+                }
+            }
+        };
+
+        std::vector<Utility::Task> initial_tasks;
+        for (size_t i = 0; i < system_cnt; ++i)
+        {
+            if (m_system_access[i].predecessor_cnt == 0) {
+                initial_tasks.push_back([&run_system, i]() { run_system(i); });
+            }
+        }
+
+        task_scheduler.submitTasks(std::move(initial_tasks), task_group);
+        task_scheduler.wait(task_group);
+
+        propagateChanges(task_scheduler);
+    }
 }
\ No newline at end of file
@@ -1,14 +1,27 @@
 #ifndef WorldState_hpp
 #define WorldState_hpp
 
+#include <array>
+#include <atomic>
 #include <future>
 
 #include "BaseComponentManager.hpp"
 #include "EntityManager.hpp"
+#include "Query.hpp"
 #include "TaskScheduler.hpp"
 
 namespace EngineCore
 {
+    /**
+     * Lists of component manager types that a system reads from or writes to,
+     * used for declaring data access when adding a system to a world.
+     */
+    template <typename... ComponentManagerTypes>
+    struct Reads {};
+
+    template <typename... ComponentManagerTypes>
+    struct Writes {};
+
     /**
      * The state of a world instance. Made up from storage and management of all entities and all components.
      */
@@ -22,7 +35,7 @@ namespace EngineCore
         EntityManager& accessEntityManager();
 
         /**
-         *
+         * Access a registered component manager. A single array load, without locking.
          */
         template <typename ComponentManagerType>
         ComponentManagerType const& get() const;
@@ -31,37 +44,130 @@ namespace EngineCore
         ComponentManagerType & get();
 
         /**
-         *
+         * View of all entities with components in each of the given component managers,
+         * e.g. query<TransformComponentManager, RenderTaskComponentManager<RenderTaskTags::StaticMesh>, MaterialComponentManager>().
+         */
+        template <typename... ComponentManagerTypes>
+        Query<ComponentManagerTypes...> query() const;
+
+        /**
+         * Register a component manager. Each manager type can be registered once per world.
          */
         template <class ComponentManagerType>
         void add(std::unique_ptr<BaseComponentManager> &&component_mngr);
 
         /** 
-         *
+         * Add a system without declared data access. It is treated as accessing everything,
+         * i.e. it is never run concurrently with other systems.
+         */
+        void add(std::function<void(WorldState&, double, Utility::TaskScheduler&)> system);
+
+        /**
+         * Add a system that only accesses the component managers listed in ReadAccess and WriteAccess,
+         * e.g. add<Reads<TransformComponentManager>, Writes<MoveToComponentManager>>(system).
+         * Systems without conflicting access may run concurrently in runSystems.
          */
+        template <typename ReadAccess, typename WriteAccess>
         void add(std::function<void(WorldState&, double, Utility::TaskScheduler&)> system);
 
+        /**
+         * A frame loop calling the systems itself instead of using runSystems has to call
+         * applyCommandBuffers, processDestroyedEntities and propagateChanges itself as well.
+         */
         std::vector<std::function<void(WorldState&, double, Utility::TaskScheduler&)>> const& getSystems();
 
+        /**
+         * Run all systems on the task scheduler and wait for their completion.
+         * Systems with conflicting data access run in the order they were added,
+         * all other systems run concurrently.
+         * Recorded structural changes and entities destroyed since the last run are processed first,
+         * changes are propagated after all systems finished.
+         */
+        void runSystems(double dt, Utility::TaskScheduler& task_scheduler);
+
+        /**
+         * Let every component manager apply the structural changes recorded into its command buffers
+         * (the managers process their buffers concurrently).
+         * Must not run concurrently to systems, i.e. call at the frame boundary.
+         */
+        void applyCommandBuffers(Utility::TaskScheduler& task_scheduler);
+
+        /**
+         * Remove the components of all entities destroyed since the last call from every component manager
+         * (the managers process the batch concurrently) and release the entities afterwards.
+         * Must not run concurrently to systems, i.e. call at the frame boundary.
+         */
+        void processDestroyedEntities(Utility::TaskScheduler& task_scheduler);
+
+        /**
+         * Let every component manager update its derived state, e.g. world transforms, from the changes made since the last call
+         * (the managers process their changes concurrently).
+         * Must not run concurrently to systems, i.e. call at the frame boundary.
+         */
+        void propagateChanges(Utility::TaskScheduler& task_scheduler);
+
     private:
         /**
          * Entity manager for storing and managing all entities of a world.
          */
         EntityManager m_entity_manager;
 
+        /** Upper bound for the number of component manager types, i.e. for type ids */
+        static constexpr size_t max_component_manager_cnt = 256;
+
         /**
          * Type map for flexible storage of all component managers
-         * (inspired by https://gpfault.net/posts/mapping-types-to-values.txt.html)
+         * (inspired by https://gpfault.net/posts/mapping-types-to-values.txt.html).
+         * Slots are indexed by the dense type id, a slot is written once on registration,
+         * so lookups don't need to lock.
          */
-        std::unordered_map<int, std::unique_ptr<BaseComponentManager>> m_component_managers;
+        std::array<std::atomic<BaseComponentManager*>, max_component_manager_cnt> m_component_slots = {};
+
+        /** Owns the registered component managers, in order of registration */
+        std::vector<std::unique_ptr<BaseComponentManager>> m_component_managers;
 
         std::shared_mutex m_component_access_mutex;
 
+        template <typename ComponentManagerType>
+        BaseComponentManager* getComponentManager() const;
+
         /** 
          *
          */
         std::vector<std::function<void(WorldState&, double, Utility::TaskScheduler&)>> m_systems;
 
+        /**
+         * Declared data access of each system (same order as m_systems) and the resulting dependencies
+         */
+        struct SystemAccess
+        {
+            std::vector<int>    reads;       ///< type ids of read component managers
+            std::vector<int>    writes;      ///< type ids of written component managers
+            bool                exclusive;   ///< system did not declare its access
+            std::vector<size_t> successors;  ///< later systems that have to wait for this system
+            size_t              predecessor_cnt; ///< earlier systems this system has to wait for
+        };
+
+        std::vector<SystemAccess> m_system_access;
+
+        void addSystem(std::function<void(WorldState&, double, Utility::TaskScheduler&)> system, SystemAccess access);
+
+        /** Call fn(component_mngr) for all component managers concurrently and wait for completion */
+        void forEachComponentManager(Utility::TaskScheduler& task_scheduler, std::function<void(BaseComponentManager&)> const& fn);
+
+        template <typename AccessList>
+        struct AccessTypeIds;
+
+        template <typename... ComponentManagerTypes>
+        struct AccessTypeIds<Reads<ComponentManagerTypes...>> {
+            static std::vector<int> get() { return { getTypeId<ComponentManagerTypes>()... }; }
+        };
+
+        template <typename... ComponentManagerTypes>
+        struct AccessTypeIds<Writes<ComponentManagerTypes...>> {
+            static std::vector<int> get() { return { getTypeId<ComponentManagerTypes>()... }; }
+        };
+
         template <class ComponentType>
         inline static int getTypeId() {
             static const int id = last_type_id++;
@@ -77,7 +183,13 @@ namespace EngineCore
 
     inline void WorldState::add(std::function<void(WorldState&, double, Utility::TaskScheduler&)> system)
     {
-        m_systems.emplace_back(system);
+        addSystem(system, SystemAccess{ {}, {}, true, {}, 0 });
+    }
+
+    template <typename ReadAccess, typename WriteAccess>
+    inline void WorldState::add(std::function<void(WorldState&, double, Utility::TaskScheduler&)> system)
+    {
+        addSystem(system, SystemAccess{ AccessTypeIds<ReadAccess>::get(), AccessTypeIds<WriteAccess>::get(), false, {}, 0 });
     }
 
     inline std::vector<std::function<void(WorldState&, double, Utility::TaskScheduler&)>> const & WorldState::getSystems()
@@ -86,34 +198,57 @@ namespace EngineCore
     }
 
     template <typename ComponentManagerType>
-    inline ComponentManagerType const& WorldState::get() const
+    inline BaseComponentManager* WorldState::getComponentManager() const
     {
-        std::shared_lock<std::shared_mutex> lock(m_component_access_mutex);
+        size_t type_id = static_cast<size_t>(getTypeId<ComponentManagerType>());
+
+        assert(type_id < max_component_manager_cnt && "Component manager not registered");
 
-        const auto it = m_component_managers.find(getTypeId<ComponentManagerType>());
-        assert(it != m_component_managers.end());
-        return (*(static_cast<ComponentManagerType*>(it->second.get())));
+        BaseComponentManager* component_mngr = m_component_slots[type_id].load(std::memory_order_acquire);
+
+        assert(component_mngr != nullptr && "Component manager not registered");
+
+        return component_mngr;
+    }
+
+    template <typename ComponentManagerType>
+    inline ComponentManagerType const& WorldState::get() const
+    {
+        return (*(static_cast<ComponentManagerType const*>(getComponentManager<ComponentManagerType>())));
     }
 
     template <typename ComponentManagerType>
     inline ComponentManagerType& WorldState::get()
     {
-        std::shared_lock<std::shared_mutex> lock(m_component_access_mutex);
+        return (*(static_cast<ComponentManagerType*>(getComponentManager<ComponentManagerType>())));
+    }
 
-        const auto it = m_component_managers.find(getTypeId<ComponentManagerType>());
-        assert(it != m_component_managers.end());
-        return (*(static_cast<ComponentManagerType*>(it->second.get())));
+    template <typename... ComponentManagerTypes>
+    inline Query<ComponentManagerTypes...> WorldState::query() const
+    {
+        return Query<ComponentManagerTypes...>(get<ComponentManagerTypes>()...);
     }
 
     template <class ComponentManagerType>
     inline void WorldState::add(std::unique_ptr<BaseComponentManager> &&component_mngr)
     {
+        size_t type_id = static_cast<size_t>(getTypeId<ComponentManagerType>());
+
+        assert(type_id < max_component_manager_cnt && "Too many component manager types");
+
+        if (type_id >= max_component_manager_cnt) {
+            return;
+        }
+
         std::unique_lock<std::shared_mutex> lock(m_component_access_mutex);
 
-        m_component_managers.emplace(
-            getTypeId<ComponentManagerType>(), 
-            std::forward<std::unique_ptr<BaseComponentManager>>(component_mngr)
-        );
+        // registering a manager type a second time keeps the first manager
+        if (m_component_slots[type_id].load(std::memory_order_relaxed) != nullptr) {
+            return;
+        }
+
+        m_component_slots[type_id].store(component_mngr.get(), std::memory_order_release);
+        m_component_managers.push_back(std::forward<std::unique_ptr<BaseComponentManager>>(component_mngr));
     }
 
 }
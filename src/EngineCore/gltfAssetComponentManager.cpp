@@ -97,6 +97,13 @@ void EngineCore::Graphics::GltfAssetComponentManager::addComponent(
     m_data.push_back({ entity,gltf_filepath,gltf_node_idx });
 }
 
+void EngineCore::Graphics::GltfAssetComponentManager::deleteComponents(std::span<Entity const> entities)
+{
+    std::unique_lock<std::shared_mutex> lock(m_data_mutex);
+
+    eraseComponents(entities, m_data);
+}
+
 std::vector<EngineCore::Graphics::GltfAssetComponentManager::ComponentData> EngineCore::Graphics::GltfAssetComponentManager::getComponents() const
 {
     std::vector<EngineCore::Graphics::GltfAssetComponentManager::ComponentData> retval;
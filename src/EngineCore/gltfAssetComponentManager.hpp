@@ -60,6 +60,8 @@ namespace EngineCore
 
             void addComponent(Entity entity, std::string const& gltf_filepath, size_t gltf_node_idx);
 
+            void deleteComponents(std::span<Entity const> entities) override;
+
             ModelPtr addGltfModelToCache(std::string const& gltf_filepath);
 
             void addGltfModelToCache(std::string const& gltf_filepath, ModelPtr const& gltf_model);
@@ -279,6 +279,10 @@ namespace EngineCore
                     {
                         auto primitive_cnt = model->meshes[model->nodes[gltf_node_idx].mesh].primitives.size();
 
+                        // render tasks of all primitives are added together, each add merges into the sorted task list
+                        std::vector<typename EngineCore::Graphics::RenderTaskComponentManager<EngineCore::Graphics::RenderTaskTags::StaticMesh>::Data> staticMesh_render_tasks;
+                        std::vector<typename EngineCore::Graphics::RenderTaskComponentManager<EngineCore::Graphics::RenderTaskTags::SkinnedMesh>::Data> skinnedMesh_render_tasks;
+
                         for (size_t primitive_idx = 0; primitive_idx < primitive_cnt; ++primitive_idx)
                         {
                             // add bbox component
@@ -581,24 +585,26 @@ namespace EngineCore
 
                             //for (int subidx = 0; subidx < component_idxs.size(); ++subidx)
                             if (model->nodes[gltf_node_idx].skin != -1) {
-                                skinnedMesh_renderTask_mngr.addComponent(
+                                skinnedMesh_render_tasks.emplace_back(
                                     entity,
                                     mesh_rsrc,
                                     mesh_subidx,
                                     dflt_shader_prgm,
                                     mtl_subidx,
+                                    true,
                                     transform_mngr.getIndex(entity),
                                     mesh_mngr.getIndex(entity)[mesh_subidx],
                                     mtl_mngr.getIndex(entity)[mtl_subidx]
                                 );
                             }
                             else {
-                                staticMesh_renderTask_mngr.addComponent(
+                                staticMesh_render_tasks.emplace_back(
                                     entity,
                                     mesh_rsrc,
                                     mesh_subidx,
                                     dflt_shader_prgm,
                                     mtl_subidx,
+                                    true,
                                     transform_mngr.getIndex(entity),
                                     mesh_mngr.getIndex(entity)[mesh_subidx],
                                     mtl_mngr.getIndex(entity)[mtl_subidx]
@@ -610,6 +616,9 @@ namespace EngineCore
                             //renderTask_mngr.getComponentData().back().cached_mesh_idx = mesh_mngr.getIndex(entity)[mesh_subidx];
                             //renderTask_mngr.getComponentData().back().cached_material_idx = mtl_mngr.getIndex(entity)[mtl_subidx];
                         }
+
+                        staticMesh_renderTask_mngr.addComponents(staticMesh_render_tasks);
+                        skinnedMesh_renderTask_mngr.addComponents(skinnedMesh_render_tasks);
                     }
                 }
             }
@@ -0,0 +1,115 @@
+#include <atomic>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "CommandBuffer.hpp"
+
+using EngineCore::Utility::CommandBuffer;
+
+namespace
+{
+    int failed_checks = 0;
+
+    void check(bool condition, std::string const& message)
+    {
+        if (!condition)
+        {
+            std::cerr << "FAILED: " << message << std::endl;
+            ++failed_checks;
+        }
+    }
+
+    struct Command
+    {
+        int thread_idx;
+        int sequence_idx;
+    };
+
+    void testTakeInRecordingOrder()
+    {
+        CommandBuffer<Command> command_buffer;
+        std::vector<Command> commands;
+
+        for (int i = 0; i < 4; ++i) {
+            command_buffer.record({ 0, i });
+        }
+
+        command_buffer.take(commands);
+
+        check(commands.size() == 4, "all recorded commands are taken");
+        for (int i = 0; i < static_cast<int>(commands.size()); ++i) {
+            check(commands[i].sequence_idx == i, "commands are taken in order of recording");
+        }
+
+        commands.clear();
+        command_buffer.take(commands);
+
+        check(commands.empty(), "taken commands are not taken again");
+    }
+
+    void testRecordWhileTaking()
+    {
+        CommandBuffer<Command> command_buffer;
+
+        constexpr int thread_cnt = 4;
+        constexpr int command_cnt = 20000;
+
+        std::atomic_int finished_thread_cnt = 0;
+
+        std::vector<std::thread> threads;
+        for (int thread_idx = 0; thread_idx < thread_cnt; ++thread_idx)
+        {
+            threads.emplace_back([&command_buffer, &finished_thread_cnt, thread_idx]() {
+                for (int i = 0; i < command_cnt; ++i) {
+                    command_buffer.record({ thread_idx, i });
+                }
+                ++finished_thread_cnt;
+            });
+        }
+
+        // take concurrently to recording until all threads are done, then take the rest
+        std::vector<Command> commands;
+        size_t take_cnt = 0;
+        while (finished_thread_cnt.load() < thread_cnt)
+        {
+            command_buffer.take(commands);
+            ++take_cnt;
+        }
+
+        for (auto& thread : threads) {
+            thread.join();
+        }
+
+        command_buffer.take(commands);
+
+        check(take_cnt > 0, "commands are taken while threads are recording");
+        check(commands.size() == static_cast<size_t>(thread_cnt * command_cnt), "no command is lost or duplicated");
+
+        std::vector<int> next_sequence_idx(thread_cnt, 0);
+        bool in_order = true;
+        for (auto const& command : commands)
+        {
+            in_order = in_order && (command.sequence_idx == next_sequence_idx[command.thread_idx]);
+            next_sequence_idx[command.thread_idx] = command.sequence_idx + 1;
+        }
+
+        check(in_order, "commands of each thread are taken once and in order of recording");
+    }
+}
+
+int main()
+{
+    testTakeInRecordingOrder();
+    testRecordWhileTaking();
+
+    if (failed_checks > 0)
+    {
+        std::cerr << failed_checks << " checks failed" << std::endl;
+        return 1;
+    }
+
+    std::cout << "All checks passed" << std::endl;
+    return 0;
+}
@@ -0,0 +1,143 @@
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "RenderThreadScheduler.hpp"
+
+using EngineCore::Utility::RenderThreadScheduler;
+typedef RenderThreadScheduler::Priority Priority;
+typedef std::chrono::duration<double, std::milli> Milliseconds;
+
+namespace
+{
+    int failed_checks = 0;
+
+    void check(bool condition, std::string const& message)
+    {
+        if (!condition)
+        {
+            std::cerr << "FAILED: " << message << std::endl;
+            ++failed_checks;
+        }
+    }
+
+    /**
+     * Clock that only advances when mock tasks pretend to do work
+     */
+    struct FakeClock
+    {
+        RenderThreadScheduler::Clock::time_point now;
+
+        void advance(double ms) { now += std::chrono::duration_cast<RenderThreadScheduler::Clock::duration>(Milliseconds(ms)); }
+    };
+
+    /**
+     * Submit a mock task that takes the given time and logs its id once executed
+     */
+    void submitMockTask(RenderThreadScheduler& scheduler, FakeClock& clock, std::vector<int>& log, int id, double duration_ms, Priority priority)
+    {
+        scheduler.submit([&clock, &log, id, duration_ms]() {
+            clock.advance(duration_ms);
+            log.push_back(id);
+            }, priority);
+    }
+
+    void testCriticalTasksIgnoreBudget()
+    {
+        FakeClock clock;
+        RenderThreadScheduler scheduler([&clock]() { return clock.now; });
+        std::vector<int> log;
+
+        for (int i = 0; i < 5; ++i) {
+            submitMockTask(scheduler, clock, log, i, 10.0, Priority::CRITICAL);
+        }
+
+        size_t executed_cnt = scheduler.process(Milliseconds(1.0));
+
+        check(executed_cnt == 5, "all critical tasks run although they exceed the budget");
+        check(log == std::vector<int>({ 0, 1, 2, 3, 4 }), "critical tasks run in submission order");
+        check(scheduler.getPendingTaskCount() == 0, "no critical task is carried over");
+    }
+
+    void testBudgetDefersNonCriticalTasks()
+    {
+        FakeClock clock;
+        RenderThreadScheduler scheduler([&clock]() { return clock.now; });
+        std::vector<int> log;
+
+        for (int i = 0; i < 6; ++i) {
+            submitMockTask(scheduler, clock, log, i, 1.0, Priority::STREAMING);
+        }
+        for (int i = 100; i < 103; ++i) {
+            submitMockTask(scheduler, clock, log, i, 1.0, Priority::BACKGROUND);
+        }
+
+        // streaming tasks start at 0, 1, 2 and 3 ms, the budget is used up at 4 ms
+        scheduler.process(Milliseconds(3.5));
+
+        check(log == std::vector<int>({ 0, 1, 2, 3, 100 }), "streaming tasks are cut off by the budget, one background task runs");
+        check(scheduler.getPendingTaskCount() == 4, "tasks beyond the budget are carried over");
+
+        log.clear();
+        scheduler.process(Milliseconds(3.5));
+
+        check(log == std::vector<int>({ 4, 5, 101, 102 }), "carried over tasks run in order in the next frame");
+        check(scheduler.getPendingTaskCount() == 0, "all tasks are executed after two frames");
+
+        log.clear();
+        submitMockTask(scheduler, clock, log, 0, 1.0, Priority::STREAMING);
+        submitMockTask(scheduler, clock, log, 100, 1.0, Priority::BACKGROUND);
+        submitMockTask(scheduler, clock, log, 200, 1.0, Priority::CRITICAL);
+        scheduler.process(Milliseconds(10.0));
+
+        check(log == std::vector<int>({ 200, 0, 100 }), "tasks run in order of priority");
+    }
+
+    void testNoClassStarves()
+    {
+        FakeClock clock;
+        RenderThreadScheduler scheduler([&clock]() { return clock.now; });
+        std::vector<int> log;
+
+        constexpr int frame_cnt = 8;
+
+        for (int i = 0; i < frame_cnt; ++i) {
+            submitMockTask(scheduler, clock, log, 100 + i, 1.0, Priority::STREAMING);
+            submitMockTask(scheduler, clock, log, 200 + i, 1.0, Priority::BACKGROUND);
+        }
+
+        for (int frame = 0; frame < frame_cnt; ++frame)
+        {
+            // each frame, critical work alone uses up the budget and new streaming work keeps arriving
+            submitMockTask(scheduler, clock, log, frame, 20.0, Priority::CRITICAL);
+            submitMockTask(scheduler, clock, log, 300 + frame, 1.0, Priority::STREAMING);
+
+            log.clear();
+            scheduler.process(Milliseconds(5.0));
+
+            check(log.size() == 3, "one task per class runs in an overloaded frame");
+            check(log.size() == 3 && log[0] == frame, "critical task runs in its frame");
+            check(log.size() == 3 && log[1] == 100 + frame, "streaming tasks make progress in order");
+            check(log.size() == 3 && log[2] == 200 + frame, "background tasks make progress in order");
+        }
+
+        check(scheduler.getPendingTaskCount() == frame_cnt, "only the streaming tasks submitted during the frames are pending");
+    }
+}
+
+int main()
+{
+    testCriticalTasksIgnoreBudget();
+    testBudgetDefersNonCriticalTasks();
+    testNoClassStarves();
+
+    if (failed_checks > 0)
+    {
+        std::cerr << failed_checks << " checks failed" << std::endl;
+        return 1;
+    }
+
+    std::cout << "All checks passed" << std::endl;
+    return 0;
+}